@@ -25,6 +25,7 @@
 #include <libavcodec/mediacodec.h>
 
 #include "android_utils.h"
+#include "glbindings.h"
 #include "jni_utils.h"
 #include "log.h"
 #include "memory.h"
@@ -416,6 +417,8 @@ int ngli_android_surface_render_buffer(struct android_surface *surface, AVMediaC
     }
 
     (*env)->CallVoidMethod(env, surface->surface_texture, surface->jfields.update_tex_image_id);
+    /* The texture is bound by the SurfaceTexture behind our back */
+    ngli_glbindings_invalidate();
     if ((ret = ngli_jni_exception_check(env, 1)) < 0) {
         goto fail;
     }
@@ -19,9 +19,11 @@
  * under the License.
  */
 
+#include <float.h>
 #include <stdlib.h>
 #include <pthread.h>
 #include <stdio.h>
+#include <string.h>
 
 #if defined(TARGET_ANDROID)
 #include <jni.h>
@@ -36,40 +38,95 @@
 #include "memory.h"
 #include "nodegl.h"
 #include "nodes.h"
+#include "program.h"
+#include "program_cache.h"
+
+static int create_update_pool(struct ngl_ctx *s)
+{
+    if (s->config.nb_update_threads <= 1)
+        return 0;
+
+    s->update_pool = ngli_threadpool_create(s->config.nb_update_threads);
+    if (!s->update_pool) {
+        LOG(ERROR, "unable to create an update pool of %d threads",
+            s->config.nb_update_threads);
+        return -1;
+    }
+    return 0;
+}
 
 static int cmd_reconfigure(struct ngl_ctx *s, void *arg)
 {
+    const struct ngl_config *config = arg;
+
     int ret = s->backend->reconfigure(s, arg);
-    if (ret < 0)
+    if (ret < 0) {
         LOG(ERROR, "unable to reconfigure %s", s->backend->name);
-    return ret;
+        return ret;
+    }
+
+    if (config->nb_update_threads != s->config.nb_update_threads) {
+        ngli_threadpool_freep(&s->update_pool);
+        s->config.nb_update_threads = config->nb_update_threads;
+        return create_update_pool(s);
+    }
+
+    return 0;
 }
 
 static int cmd_configure(struct ngl_ctx *s, void *arg)
 {
     int ret = s->backend->configure(s, arg);
-    if (ret < 0)
+    if (ret < 0) {
         LOG(ERROR, "unable to configure %s", s->backend->name);
-    return ret;
+        return ret;
+    }
+
+    return create_update_pool(s);
 }
 
 static int cmd_set_scene(struct ngl_ctx *s, void *arg)
 {
+    struct ngl_node *scene = arg;
+
+    /* The committed changes target the nodes of the current scene */
+    int ret = ngli_param_batch_apply_committed(&s->committed_batches);
+    if (ret < 0)
+        return ret;
+
+    s->activity_end = s->activity_start;
+    s->graph_changed = 0;
+
     if (s->scene) {
+        s->prefetch_queue.count = 0;
+        ngli_plan_reset(&s->plan);
+        /* The reusable nodes are kept initialized until the new scene is attached */
+        if (s->config.hot_swap && scene && (ret = ngli_node_reusable_init(s)) < 0)
+            return ret;
         ngli_node_detach_ctx(s->scene);
         ngl_node_unrefp(&s->scene);
     }
 
-    struct ngl_node *scene = arg;
     if (!scene)
         return 0;
 
-    int ret = ngli_node_attach_ctx(scene, s);
+    ret = s->config.lazy_init ? ngli_node_attach_ctx_lazy(scene, s)
+                              : ngli_node_attach_ctx(scene, s);
+    ngli_node_reusable_reset(s);
+    ngli_program_build_reset(s);
     if (ret < 0) {
         ngli_node_detach_ctx(scene);
         return ret;
     }
 
+    if (s->config.compiled_scene) {
+        ret = ngli_plan_init(&s->plan, scene);
+        if (ret < 0) {
+            ngli_node_detach_ctx(scene);
+            return ret;
+        }
+    }
+
     s->scene = ngl_node_ref(scene);
     return 0;
 }
@@ -78,6 +135,10 @@ static int cmd_prepare_draw(struct ngl_ctx *s, void *arg)
 {
     const double t = *(double *)arg;
 
+    int ret = ngli_param_batch_apply_committed(&s->committed_batches);
+    if (ret < 0)
+        return ret;
+
     struct ngl_node *scene = s->scene;
     if (!scene) {
         return 0;
@@ -85,16 +146,52 @@ static int cmd_prepare_draw(struct ngl_ctx *s, void *arg)
 
     LOG(DEBUG, "prepare scene %s @ t=%f", scene->label, t);
 
-    s->activitycheck_nodes.count = 0;
-    int ret = ngli_node_visit(scene, 1, t);
-    if (ret < 0)
-        return ret;
+    /*
+     * The activity of the nodes only changes at time boundaries (declared by
+     * the nodes through activity_start/activity_end during the visit) or
+     * with a live change (such as a UserSwitch toggle), so the visit can be
+     * skipped as long as t stays in the interval computed by the last one.
+     */
+    if (t < s->activity_start || t >= s->activity_end ||
+        s->activity_gen != s->live_change_gen) {
+        s->activity_start = -DBL_MAX;
+        s->activity_end = DBL_MAX;
+        s->activity_gen = s->live_change_gen;
+
+        s->activitycheck_nodes.count = 0;
+        ret = ngli_node_visit(scene, 1, t);
+        if (ret >= 0)
+            ret = ngli_node_honor_release_prefetch(s);
+        if (ret < 0) {
+            s->activity_end = s->activity_start;
+            return ret;
+        }
+
+        /* Lazily initialized nodes have new children to compile */
+        if (s->graph_changed && s->config.compiled_scene) {
+            ngli_plan_reset(&s->plan);
+            ret = ngli_plan_init(&s->plan, scene);
+            if (ret < 0)
+                return ret;
+        }
+        s->graph_changed = 0;
+    } else {
+        /* Continue the prefetches postponed by the budget of a previous frame */
+        ret = ngli_node_prefetch_deferred(s);
+        if (ret < 0) {
+            s->activity_end = s->activity_start;
+            return ret;
+        }
+    }
 
-    ret = ngli_node_honor_release_prefetch(&s->activitycheck_nodes);
+    ret = ngli_node_update_parallel(s, t);
     if (ret < 0)
         return ret;
 
-    ret = ngli_node_update(scene, t);
+    if (s->config.compiled_scene)
+        ret = ngli_plan_update(&s->plan, t);
+    else
+        ret = ngli_node_update(scene, t);
     if (ret < 0)
         return ret;
 
@@ -105,7 +202,9 @@ static int cmd_draw(struct ngl_ctx *s, void *arg)
 {
     const double t = *(double *)arg;
 
+    NGLI_TRACER_BEGIN(s->tracer, "pre_draw", NULL);
     int ret = s->backend->pre_draw(s, t);
+    NGLI_TRACER_END(s->tracer);
     if (ret < 0)
         goto end;
 
@@ -115,34 +214,236 @@ static int cmd_draw(struct ngl_ctx *s, void *arg)
 
     if (s->scene) {
         LOG(DEBUG, "draw scene %s @ t=%f", s->scene->label, t);
-        ngli_node_draw(s->scene);
+        if (s->config.compiled_scene)
+            ngli_plan_draw(&s->plan);
+        else
+            ngli_node_draw(s->scene);
     }
 
 end:;
+    NGLI_TRACER_BEGIN(s->tracer, "post_draw", NULL);
     int end_ret = s->backend->post_draw(s, t);
+    NGLI_TRACER_END(s->tracer);
     if (end_ret < 0)
         return end_ret;
 
     return ret;
 }
 
+struct draw_range {
+    double t0;
+    double t1;
+    double rate;
+    ngl_frame_callback_type callback;
+    void *user_arg;
+};
+
+static int cmd_draw_range(struct ngl_ctx *s, void *arg)
+{
+    const struct draw_range *range = arg;
+
+    for (int i = 0;; i++) {
+        double t = range->t0 + i / range->rate;
+        if (t >= range->t1)
+            break;
+
+        int ret = cmd_draw(s, &t);
+        if (ret < 0)
+            return ret;
+
+        if (range->callback) {
+            ret = range->callback(range->user_arg, i, t);
+            if (ret < 0)
+                return ret;
+        }
+    }
+
+    return 0;
+}
+
+static int cmd_get_memory_stats(struct ngl_ctx *s, void *arg)
+{
+    struct ngl_memory_stats *stats = arg;
+
+    if (!s->configured) {
+        LOG(ERROR, "context must be configured before querying the memory statistics");
+        return -1;
+    }
+
+    ngli_memstats_copy(stats, &s->glcontext->memstats);
+    return 0;
+}
+
+static int cmd_get_program_cache_stats(struct ngl_ctx *s, void *arg)
+{
+    struct ngl_program_cache_stats *stats = arg;
+
+    if (!s->configured) {
+        LOG(ERROR, "context must be configured before querying the program cache statistics");
+        return -1;
+    }
+
+    if (s->program_cache)
+        ngli_program_cache_get_stats(s->program_cache, stats);
+    else
+        memset(stats, 0, sizeof(*stats));
+    return 0;
+}
+
+static int cmd_get_uniform_stats(struct ngl_ctx *s, void *arg)
+{
+    struct ngl_uniform_stats *stats = arg;
+
+    if (!s->configured) {
+        LOG(ERROR, "context must be configured before querying the uniform statistics");
+        return -1;
+    }
+
+    *stats = s->glcontext->uniform_stats;
+    return 0;
+}
+
+static int cmd_get_binding_stats(struct ngl_ctx *s, void *arg)
+{
+    struct ngl_binding_stats *stats = arg;
+
+    if (!s->configured) {
+        LOG(ERROR, "context must be configured before querying the binding statistics");
+        return -1;
+    }
+
+    ngli_glbindings_get_stats(s->glcontext->bindings, stats);
+    return 0;
+}
+
+static int cmd_get_sort_stats(struct ngl_ctx *s, void *arg)
+{
+    struct ngl_sort_stats *stats = arg;
+
+    if (!s->configured) {
+        LOG(ERROR, "context must be configured before querying the sort statistics");
+        return -1;
+    }
+
+    *stats = s->sort_stats;
+    return 0;
+}
+
+static int cmd_trace_start(struct ngl_ctx *s, void *arg)
+{
+    const char *filename = arg;
+
+    if (s->tracer) {
+        LOG(ERROR, "a trace is already being recorded");
+        return -1;
+    }
+
+    struct tracer *tracer = ngli_tracer_create(filename);
+    if (!tracer)
+        return -1;
+    __atomic_store_n(&s->tracer, tracer, __ATOMIC_RELEASE);
+    return 0;
+}
+
+static int cmd_trace_stop(struct ngl_ctx *s, void *arg)
+{
+    struct tracer *tracer = s->tracer;
+    if (!tracer)
+        return 0;
+
+    /* The prefetch thread may still be recording an event */
+    __atomic_store_n(&s->tracer, NULL, __ATOMIC_RELEASE);
+    if (s->prefetcher)
+        ngli_prefetcher_wait_idle(s->prefetcher);
+
+    return ngli_tracer_freep(&tracer);
+}
+
 static int cmd_stop(struct ngl_ctx *s, void *arg)
 {
     s->backend->destroy(s);
+    ngli_threadpool_freep(&s->update_pool);
+    ngli_tracer_freep(&s->tracer);
     return 0;
 }
 
-static int dispatch_cmd(struct ngl_ctx *s, cmd_func_type cmd_func, void *arg)
+/*
+ * The controller and the worker communicate through a single-producer
+ * single-consumer ring of commands: the controller writes the commands and
+ * advances cmd_write_pos, the worker executes them in order and advances
+ * cmd_read_pos. Both sides spin for a short while before going to sleep on
+ * their condition, and each side only takes the lock to wake the other one if
+ * it is actually sleeping.
+ */
+#define SPIN_COUNT 1000
+
+static unsigned load_pos(const unsigned *pos)
+{
+    return __atomic_load_n(pos, __ATOMIC_SEQ_CST);
+}
+
+static void store_pos(unsigned *pos, unsigned value)
 {
+    __atomic_store_n(pos, value, __ATOMIC_SEQ_CST);
+}
+
+static void wait_pos(struct ngl_ctx *s, const unsigned *pos, unsigned value,
+                     int *sleeping, pthread_cond_t *cond)
+{
+    for (int i = 0; i < SPIN_COUNT; i++)
+        if (load_pos(pos) != value)
+            return;
+
     pthread_mutex_lock(&s->lock);
-    s->cmd_func = cmd_func;
-    s->cmd_arg = arg;
-    pthread_cond_signal(&s->cond_wkr);
-    while (s->cmd_func)
-        pthread_cond_wait(&s->cond_ctl, &s->lock);
+    __atomic_store_n(sleeping, 1, __ATOMIC_SEQ_CST);
+    while (load_pos(pos) == value)
+        pthread_cond_wait(cond, &s->lock);
+    __atomic_store_n(sleeping, 0, __ATOMIC_SEQ_CST);
     pthread_mutex_unlock(&s->lock);
+}
+
+static void wake(struct ngl_ctx *s, const int *sleeping, pthread_cond_t *cond)
+{
+    if (!__atomic_load_n(sleeping, __ATOMIC_SEQ_CST))
+        return;
+    pthread_mutex_lock(&s->lock);
+    pthread_cond_signal(cond);
+    pthread_mutex_unlock(&s->lock);
+}
+
+/* Wait until the worker has executed all the commands up to pos (excluded) */
+static void wait_cmds(struct ngl_ctx *s, unsigned pos)
+{
+    unsigned read_pos;
+    while ((int)(pos - (read_pos = load_pos(&s->cmd_read_pos))) > 0)
+        wait_pos(s, &s->cmd_read_pos, read_pos, &s->ctl_sleeping, &s->cond_ctl);
+}
 
-    return s->cmd_ret;
+static struct cmd *push_cmd(struct ngl_ctx *s, cmd_func_type cmd_func, void *arg, int sync)
+{
+    const unsigned write_pos = s->cmd_write_pos;
+    wait_cmds(s, write_pos - NGLI_CMD_RING_SIZE + 1);
+
+    struct cmd *cmd = &s->cmd_ring[write_pos & (NGLI_CMD_RING_SIZE - 1)];
+    cmd->func = cmd_func;
+    cmd->arg = arg;
+    cmd->sync = sync;
+    cmd->ret = 0;
+    return cmd;
+}
+
+static void commit_cmd(struct ngl_ctx *s)
+{
+    store_pos(&s->cmd_write_pos, s->cmd_write_pos + 1);
+    wake(s, &s->wkr_sleeping, &s->cond_wkr);
+}
+
+static int dispatch_cmd(struct ngl_ctx *s, cmd_func_type cmd_func, void *arg)
+{
+    struct cmd *cmd = push_cmd(s, cmd_func, arg, 1);
+    commit_cmd(s);
+    wait_cmds(s, s->cmd_write_pos);
+    return cmd->ret;
 }
 
 static void *worker_thread(void *arg)
@@ -151,19 +452,26 @@ static void *worker_thread(void *arg)
 
     ngli_thread_set_name("ngl-thread");
 
-    pthread_mutex_lock(&s->lock);
     for (;;) {
-        while (!s->cmd_func)
-            pthread_cond_wait(&s->cond_wkr, &s->lock);
-        s->cmd_ret = s->cmd_func(s, s->cmd_arg);
-        int need_stop = s->cmd_func == cmd_stop;
-        s->cmd_func = s->cmd_arg = NULL;
-        pthread_cond_signal(&s->cond_ctl);
+        /*
+         * This returns immediately as long as commands are pending, so all
+         * the commands queued meanwhile are executed in a single wakeup.
+         */
+        const unsigned read_pos = s->cmd_read_pos;
+        wait_pos(s, &s->cmd_write_pos, read_pos, &s->wkr_sleeping, &s->cond_wkr);
+
+        struct cmd *cmd = &s->cmd_ring[read_pos & (NGLI_CMD_RING_SIZE - 1)];
+        const int need_stop = cmd->func == cmd_stop;
+        cmd->ret = cmd->func(s, cmd->sync ? cmd->arg : &cmd->t);
+        if (!cmd->sync && cmd->ret < 0 && !s->async_ret)
+            s->async_ret = cmd->ret;
+
+        store_pos(&s->cmd_read_pos, read_pos + 1);
+        wake(s, &s->ctl_sleeping, &s->cond_ctl);
 
         if (need_stop)
             break;
     }
-    pthread_mutex_unlock(&s->lock);
 
     return NULL;
 }
@@ -232,6 +540,9 @@ struct ngl_ctx *ngl_create(void)
     ngli_darray_init(&s->modelview_matrix_stack, 4 * 4 * sizeof(float), 1);
     ngli_darray_init(&s->projection_matrix_stack, 4 * 4 * sizeof(float), 1);
     ngli_darray_init(&s->activitycheck_nodes, sizeof(struct ngl_node *), 0);
+    ngli_darray_init(&s->parallel_update_nodes, sizeof(struct ngl_node *), 0);
+    ngli_darray_init(&s->prefetch_queue, sizeof(struct ngl_node *), 0);
+    ngli_darray_init(&s->program_builds, sizeof(struct program_build *), 0);
 
     static const NGLI_ALIGNED_MAT(id_matrix) = NGLI_MAT4_IDENTITY;
     if (!ngli_darray_push(&s->modelview_matrix_stack, id_matrix) ||
@@ -341,6 +652,11 @@ int ngl_set_scene(struct ngl_ctx *s, struct ngl_node *scene)
         return -1;
     }
 
+    if (s->param_batch) {
+        LOG(ERROR, "the parameter batch must be committed before setting a scene");
+        return -1;
+    }
+
     return dispatch_cmd(s, cmd_set_scene, scene);
 }
 
@@ -364,6 +680,117 @@ int ngl_draw(struct ngl_ctx *s, double t)
     return dispatch_cmd(s, cmd_draw, &t);
 }
 
+int ngl_draw_range(struct ngl_ctx *s, double t0, double t1, double rate,
+                   ngl_frame_callback_type callback, void *user_arg)
+{
+    if (!s->configured) {
+        LOG(ERROR, "context must be configured before drawing");
+        return -1;
+    }
+
+    if (rate <= 0) {
+        LOG(ERROR, "invalid frame rate %g", rate);
+        return -1;
+    }
+
+    struct draw_range range = {
+        .t0       = t0,
+        .t1       = t1,
+        .rate     = rate,
+        .callback = callback,
+        .user_arg = user_arg,
+    };
+    return dispatch_cmd(s, cmd_draw_range, &range);
+}
+
+int ngl_draw_async(struct ngl_ctx *s, double t)
+{
+    if (!s->configured) {
+        LOG(ERROR, "context must be configured before drawing");
+        return -1;
+    }
+
+    struct cmd *cmd = push_cmd(s, cmd_draw, NULL, 0);
+    cmd->t = t;
+    commit_cmd(s);
+
+    return 0;
+}
+
+int ngl_param_batch_begin(struct ngl_ctx *s)
+{
+    if (s->param_batch) {
+        LOG(ERROR, "a parameter batch is already opened");
+        return -1;
+    }
+
+    s->param_batch = ngli_param_batch_create();
+    if (!s->param_batch)
+        return -1;
+    return 0;
+}
+
+int ngl_param_batch_commit(struct ngl_ctx *s)
+{
+    struct param_batch *batch = s->param_batch;
+    if (!batch) {
+        LOG(ERROR, "no parameter batch opened");
+        return -1;
+    }
+
+    s->param_batch = NULL;
+    ngli_param_batch_commit(&s->committed_batches, batch);
+    return 0;
+}
+
+int ngl_get_memory_stats(struct ngl_ctx *s, struct ngl_memory_stats *stats)
+{
+    return dispatch_cmd(s, cmd_get_memory_stats, stats);
+}
+
+int ngl_get_program_cache_stats(struct ngl_ctx *s, struct ngl_program_cache_stats *stats)
+{
+    return dispatch_cmd(s, cmd_get_program_cache_stats, stats);
+}
+
+int ngl_get_uniform_stats(struct ngl_ctx *s, struct ngl_uniform_stats *stats)
+{
+    return dispatch_cmd(s, cmd_get_uniform_stats, stats);
+}
+
+int ngl_get_binding_stats(struct ngl_ctx *s, struct ngl_binding_stats *stats)
+{
+    return dispatch_cmd(s, cmd_get_binding_stats, stats);
+}
+
+int ngl_get_sort_stats(struct ngl_ctx *s, struct ngl_sort_stats *stats)
+{
+    return dispatch_cmd(s, cmd_get_sort_stats, stats);
+}
+
+int ngl_trace_start(struct ngl_ctx *s, const char *filename)
+{
+    if (!filename) {
+        LOG(ERROR, "trace filename cannot be NULL");
+        return -1;
+    }
+
+    return dispatch_cmd(s, cmd_trace_start, (void *)filename);
+}
+
+int ngl_trace_stop(struct ngl_ctx *s)
+{
+    return dispatch_cmd(s, cmd_trace_stop, NULL);
+}
+
+int ngl_wait(struct ngl_ctx *s)
+{
+    wait_cmds(s, s->cmd_write_pos);
+    const int ret = s->async_ret;
+    s->async_ret = 0;
+    return ret;
+}
+
 void ngl_freep(struct ngl_ctx **ss)
 {
     struct ngl_ctx *s = *ss;
@@ -371,13 +798,18 @@ void ngl_freep(struct ngl_ctx **ss)
     if (!s)
         return;
 
+    ngli_param_batch_freep(&s->param_batch);
     if (s->configured)
         ngl_set_scene(s, NULL);
 
     stop_thread(s);
+    ngli_param_batch_free_committed(&s->committed_batches);
     ngli_darray_reset(&s->modelview_matrix_stack);
     ngli_darray_reset(&s->projection_matrix_stack);
     ngli_darray_reset(&s->activitycheck_nodes);
+    ngli_darray_reset(&s->parallel_update_nodes);
+    ngli_darray_reset(&s->prefetch_queue);
+    ngli_darray_reset(&s->program_builds);
     ngli_free(*ss);
     *ss = NULL;
 }
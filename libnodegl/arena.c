@@ -0,0 +1,117 @@
+/*
+ * Copyright 2018 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#include <stdint.h>
+#include <string.h>
+
+#include "arena.h"
+#include "memory.h"
+#include "nodegl.h"
+#include "utils.h"
+
+#define CHUNK_SIZE (256 * 1024)
+
+struct arena_chunk {
+    struct arena_chunk *next;
+    size_t size;
+    size_t used;
+};
+
+struct ngl_arena {
+    struct arena_chunk *chunks; /* the first one is the chunk in use */
+    int refcount;
+};
+
+#define CHUNK_HEADER_SIZE NGLI_ALIGN(sizeof(struct arena_chunk), NGLI_ALIGN_VAL)
+
+static struct arena_chunk *chunk_create(size_t size)
+{
+    struct arena_chunk *chunk = ngli_malloc_aligned(CHUNK_HEADER_SIZE + size);
+    if (!chunk)
+        return NULL;
+    chunk->next = NULL;
+    chunk->size = size;
+    chunk->used = 0;
+    return chunk;
+}
+
+struct ngl_arena *ngl_arena_create(void)
+{
+    struct ngl_arena *s = ngli_calloc(1, sizeof(*s));
+    if (!s)
+        return NULL;
+    s->refcount = 1;
+    return s;
+}
+
+void *ngli_arena_alloc(struct ngl_arena *s, size_t size)
+{
+    size = NGLI_ALIGN(size, NGLI_ALIGN_VAL);
+
+    struct arena_chunk *chunk = s->chunks;
+    if (!chunk || chunk->size - chunk->used < size) {
+        /*
+         * Blocks larger than a quarter of a chunk get a chunk of their own,
+         * inserted behind the one in use so its free space is not lost.
+         */
+        const int dedicated = size > CHUNK_SIZE / 4;
+        struct arena_chunk *new_chunk = chunk_create(dedicated ? size : CHUNK_SIZE);
+        if (!new_chunk)
+            return NULL;
+        if (dedicated && chunk) {
+            new_chunk->next = chunk->next;
+            chunk->next = new_chunk;
+        } else {
+            new_chunk->next = chunk;
+            s->chunks = new_chunk;
+        }
+        chunk = new_chunk;
+    }
+
+    uint8_t *ptr = (uint8_t *)chunk + CHUNK_HEADER_SIZE + chunk->used;
+    chunk->used += size;
+    memset(ptr, 0, size);
+    return ptr;
+}
+
+struct ngl_arena *ngli_arena_ref(struct ngl_arena *s)
+{
+    __atomic_add_fetch(&s->refcount, 1, __ATOMIC_RELAXED);
+    return s;
+}
+
+void ngl_arena_unrefp(struct ngl_arena **sp)
+{
+    struct ngl_arena *s = *sp;
+    if (!s)
+        return;
+    if (__atomic_sub_fetch(&s->refcount, 1, __ATOMIC_ACQ_REL) == 0) {
+        struct arena_chunk *chunk = s->chunks;
+        while (chunk) {
+            struct arena_chunk *next = chunk->next;
+            ngli_free_aligned(chunk);
+            chunk = next;
+        }
+        ngli_free(s);
+    }
+    *sp = NULL;
+}
@@ -0,0 +1,41 @@
+/*
+ * Copyright 2018 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+#include "nodegl.h"
+
+/*
+ * Allocate a zeroed and NGLI_ALIGN_VAL aligned block from the arena. The
+ * block is released along with the arena, and can not be freed individually.
+ *
+ * Allocating is not thread-safe: an arena must not be used by several
+ * threads at the same time.
+ */
+void *ngli_arena_alloc(struct ngl_arena *s, size_t size);
+
+struct ngl_arena *ngli_arena_ref(struct ngl_arena *s);
+
+#endif /* ARENA_H */
@@ -22,9 +22,14 @@
 #include <string.h>
 
 #include "log.h"
+#include "memory.h"
 #include "nodes.h"
 #include "backend.h"
 #include "glcontext.h"
+#include "prefetcher.h"
+#include "program.h"
+#include "program_cache.h"
+#include "utils.h"
 
 #if defined(HAVE_VAAPI_X11)
 #include "vaapi.h"
@@ -53,6 +58,31 @@ static int gl_reconfigure(struct ngl_ctx *s, const struct ngl_config *config)
     return 0;
 }
 
+static void create_program_cache(struct ngl_ctx *s)
+{
+    struct glcontext *gl = s->glcontext;
+
+    GLint nb_formats = 0;
+    if (gl->features & NGLI_FEATURE_PROGRAM_BINARY)
+        ngli_glGetIntegerv(gl, GL_NUM_PROGRAM_BINARY_FORMATS, &nb_formats);
+    if (nb_formats <= 0) {
+        LOG(WARNING, "program binaries are not supported, the program cache is disabled");
+        return;
+    }
+
+    /* The binaries are only valid for the driver they have been retrieved from */
+    char *driver_id = ngli_asprintf("%s\n%s\n%s",
+                                    (const char *)ngli_glGetString(gl, GL_VENDOR),
+                                    (const char *)ngli_glGetString(gl, GL_RENDERER),
+                                    (const char *)ngli_glGetString(gl, GL_VERSION));
+    if (!driver_id)
+        return;
+    s->program_cache = ngli_program_cache_create(s->config.program_cache_dir, driver_id);
+    ngli_free(driver_id);
+    if (!s->program_cache)
+        LOG(WARNING, "could not create the program cache, programs will always be built");
+}
+
 static int gl_configure(struct ngl_ctx *s, const struct ngl_config *config)
 {
     memcpy(&s->config, config, sizeof(s->config));
@@ -66,6 +96,13 @@ static int gl_configure(struct ngl_ctx *s, const struct ngl_config *config)
 
     ngli_glstate_probe(s->glcontext, &s->glstate);
 
+    /* Let the driver use as many threads as it wants for the program builds */
+    if (s->glcontext->features & NGLI_FEATURE_KHR_PARALLEL_SHADER_COMPILE)
+        ngli_glMaxShaderCompilerThreadsKHR(s->glcontext, 0xFFFFFFFF);
+
+    if (s->config.program_cache_dir)
+        create_program_cache(s);
+
     const int *viewport = config->viewport;
     if (viewport[2] > 0 && viewport[3] > 0)
         ngli_glViewport(s->glcontext, viewport[0], viewport[1], viewport[2], viewport[3]);
@@ -73,6 +110,12 @@ static int gl_configure(struct ngl_ctx *s, const struct ngl_config *config)
     const float *rgba = config->clear_color;
     ngli_glClearColor(s->glcontext, rgba[0], rgba[1], rgba[2], rgba[3]);
 
+    if (s->config.prefetch_thread) {
+        s->prefetcher = ngli_prefetcher_create(s->glcontext);
+        if (!s->prefetcher)
+            LOG(WARNING, "could not create the prefetch thread, nodes will be prefetched synchronously");
+    }
+
 #if defined(HAVE_VAAPI_X11)
     int ret = ngli_vaapi_init(s);
     if (ret < 0)
@@ -86,6 +129,12 @@ static int gl_pre_draw(struct ngl_ctx *s, double t)
 {
     const struct glcontext *gl = s->glcontext;
 
+    /*
+     * The bindings may have been changed outside of node.gl since the
+     * previous frame (the context can be shared with the user one).
+     */
+    ngli_glbindings_invalidate();
+
     ngli_glClear(gl, GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
     return 0;
 }
@@ -111,6 +160,10 @@ static void gl_destroy(struct ngl_ctx *s)
 #if defined(HAVE_VAAPI_X11)
     ngli_vaapi_reset(s);
 #endif
+    ngli_program_build_reset(s);
+    ngli_program_cache_freep(&s->program_cache);
+    ngli_hmap_freep(&s->programs);
+    ngli_prefetcher_freep(&s->prefetcher);
     ngli_glcontext_freep(&s->glcontext);
 }
 
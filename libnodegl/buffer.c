@@ -33,6 +33,7 @@ int ngli_buffer_allocate(struct buffer *buffer, struct glcontext *gl, int size,
     ngli_glGenBuffers(gl, 1, &buffer->id);
     ngli_glBindBuffer(gl, GL_ARRAY_BUFFER, buffer->id);
     ngli_glBufferData(gl, GL_ARRAY_BUFFER, size, NULL, usage);
+    ngli_memstats_add(&buffer->memstats, &gl->memstats, NGL_MEMORY_BUFFERS, size);
     return 0;
 }
 
@@ -49,5 +50,6 @@ void ngli_buffer_free(struct buffer *buffer)
     if (!buffer->gl)
         return;
     ngli_glDeleteBuffers(buffer->gl, 1, &buffer->id);
+    ngli_memstats_remove(&buffer->memstats);
     memset(buffer, 0, sizeof(*buffer));
 }
@@ -23,12 +23,14 @@
 #define BUFFER_H
 
 #include "glcontext.h"
+#include "memstats.h"
 
 struct buffer {
     struct glcontext *gl;
     int size;
     int usage;
     GLuint id;
+    struct memstats_entry memstats;
 };
 
 int ngli_buffer_allocate(struct buffer *buffer, struct glcontext *gl, int size, int usage);
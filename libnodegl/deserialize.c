@@ -477,7 +477,7 @@ static int set_node_params(struct darray *nodes_array, char *str,
     return 0;
 }
 
-struct ngl_node *ngl_node_deserialize(const char *str)
+static struct ngl_node *deserialize(struct ngl_arena *arena, const char *str)
 {
     struct ngl_node *node = NULL;
     struct darray nodes_array;
@@ -513,7 +513,7 @@ struct ngl_node *ngl_node_deserialize(const char *str)
         if (*s == ' ')
             s++;
 
-        node = ngli_node_create_noconstructor(type);
+        node = ngli_node_create_noconstructor(arena, type);
         if (!node)
             break;
 
@@ -546,3 +546,13 @@ end:
     ngli_free(sstart);
     return node;
 }
+
+struct ngl_node *ngl_node_deserialize(const char *str)
+{
+    return deserialize(NULL, str);
+}
+
+struct ngl_node *ngl_node_deserialize_arena(struct ngl_arena *arena, const char *str)
+{
+    return deserialize(arena, str);
+}
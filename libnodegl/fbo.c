@@ -63,6 +63,7 @@ int ngli_fbo_init(struct fbo *fbo, struct glcontext *gl, const struct fbo_params
 
     ngli_glGenFramebuffers(gl, 1, &fbo->id);
     ngli_glBindFramebuffer(gl, GL_FRAMEBUFFER, fbo->id);
+    ngli_memstats_add(&fbo->memstats, &gl->memstats, NGL_MEMORY_FRAMEBUFFERS, 0);
 
     int color_index = 0;
     for (int i = 0; i < params->nb_attachments; i++) {
@@ -172,6 +173,7 @@ void ngli_fbo_reset(struct fbo *fbo)
         return;
 
     ngli_glDeleteFramebuffers(gl, 1, &fbo->id);
+    ngli_memstats_remove(&fbo->memstats);
 
     ngli_darray_reset(&fbo->depth_indices);
 
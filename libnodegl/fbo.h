@@ -24,6 +24,7 @@
 
 #include "darray.h"
 #include "glcontext.h"
+#include "memstats.h"
 #include "texture.h"
 
 struct fbo_params {
@@ -41,6 +42,7 @@ struct fbo {
     GLuint id;
     GLuint prev_id;
     struct darray depth_indices;
+    struct memstats_entry memstats;
 };
 
 int ngli_fbo_init(struct fbo *fbo, struct glcontext *gl, const struct fbo_params *params);
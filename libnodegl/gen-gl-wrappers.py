@@ -91,6 +91,7 @@ cmds_optional = [
     'glUniformBlockBinding',
     'glGetActiveUniformBlockName',
     'glGetActiveUniformBlockiv',
+    'glGetActiveUniformsiv',
 
     # EGL OES image
     'glEGLImageTargetTexture2DOES',
@@ -99,6 +100,15 @@ cmds_optional = [
     'glFenceSync',
     'glWaitSync',
     'glClientWaitSync',
+    'glDeleteSync',
+
+    # Parallel shader compile
+    'glMaxShaderCompilerThreadsKHR',
+
+    # Program binary
+    'glGetProgramBinary',
+    'glProgramBinary',
+    'glProgramParameteri',
 ]
 
 cmds = [
@@ -141,6 +151,9 @@ cmds = [
     'glDrawArrays',
     'glDrawElements',
 
+    # Flush
+    'glFlush',
+
     # Texture
     'glActiveTexture',
     'glBindTexture',
@@ -239,6 +252,28 @@ cmds = [
 
 ] + cmds_optional
 
+# Wrappers going through the bindings shadow of the current context (see
+# glbindings.h): the call is skipped if the filter hook returns 0
+cmds_bindings_filters = {
+    'glActiveTexture':      'ngli_glbindings_active_texture',
+    'glBindBuffer':         'ngli_glbindings_bind_buffer',
+    'glBindBufferBase':     'ngli_glbindings_bind_buffer_base',
+    'glBindBufferRange':    'ngli_glbindings_bind_buffer_range',
+    'glBindFramebuffer':    'ngli_glbindings_bind_framebuffer',
+    'glBindTexture':        'ngli_glbindings_bind_texture',
+    'glBindVertexArray':    'ngli_glbindings_bind_vertex_array',
+    'glUseProgram':         'ngli_glbindings_use_program',
+    'glViewport':           'ngli_glbindings_viewport',
+}
+
+cmds_bindings_hooks = {
+    'glDeleteBuffers':      'ngli_glbindings_delete_buffers',
+    'glDeleteFramebuffers': 'ngli_glbindings_delete_framebuffers',
+    'glDeleteProgram':      'ngli_glbindings_delete_program',
+    'glDeleteTextures':     'ngli_glbindings_delete_textures',
+    'glDeleteVertexArrays': 'ngli_glbindings_delete_vertex_arrays',
+}
+
 def get_proto_elems(xml_node):
     elems = []
     for text in xml_node.itertext():
@@ -330,8 +365,16 @@ static const struct gldefinition {
                 'func_args': ', '.join(func_args),
                 'ret_call': ret_call,
                 'flags': '0' if funcname in cmds_optional else 'M',
+                'bindings_hook': '',
         }
 
+        if funcname in cmds_bindings_filters:
+            hook = cmds_bindings_filters[funcname]
+            data['bindings_hook'] = '    if (!%s(%s))\n        return;\n' % (hook, data['func_args'])
+        elif funcname in cmds_bindings_hooks:
+            hook = cmds_bindings_hooks[funcname]
+            data['bindings_hook'] = '    %s(%s);\n' % (hook, data['func_args'])
+
         glfunctions   += '    NGLI_GL_APIENTRY %(func_ret)s (*%(func_name_nogl)s)(%(func_args_specs)s);\n' % data
         gldefinitions += '    {"%(func_name)s", offsetof(struct glfunctions, %(func_name_nogl)s), %(flags)s},\n' % data
         if funcname == 'glGetError':
@@ -345,7 +388,7 @@ static inline GLenum ngli_glGetError(const struct glcontext *gl)
             glwrappers    += '''
 static inline %(func_ret)s ngli_%(func_name)s(%(wrapper_args_specs)s)
 {
-    %(ret_assign)sgl->funcs.%(func_name_nogl)s(%(func_args)s);
+%(bindings_hook)s    %(ret_assign)sgl->funcs.%(func_name_nogl)s(%(func_args)s);
     check_error_code(gl, "%(func_name)s");
 %(ret_call)s}
 ''' % data
@@ -0,0 +1,370 @@
+/*
+ * Copyright 2018 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#include <pthread.h>
+#include <string.h>
+
+#include "glbindings.h"
+#include "memory.h"
+#include "utils.h"
+
+#define UNKNOWN ((GLuint)-1)
+
+#define NB_TEXTURE_UNITS  32
+#define NB_BUFFER_INDEXES 32
+
+enum {
+    TEXTURE_TARGET_2D,
+    TEXTURE_TARGET_3D,
+    TEXTURE_TARGET_CUBE_MAP,
+    TEXTURE_TARGET_EXTERNAL_OES,
+    TEXTURE_TARGET_RECTANGLE,
+    NB_TEXTURE_TARGETS
+};
+
+/* The indexed targets come first so they can index both tables */
+enum {
+    BUFFER_TARGET_UNIFORM,
+    BUFFER_TARGET_SHADER_STORAGE,
+    NB_INDEXED_BUFFER_TARGETS,
+    BUFFER_TARGET_ARRAY = NB_INDEXED_BUFFER_TARGETS,
+    BUFFER_TARGET_ELEMENT_ARRAY,
+    NB_BUFFER_TARGETS
+};
+
+struct glbindings {
+    GLuint program;
+    GLuint vertex_array;
+    GLuint active_texture; /* texture unit index */
+    GLuint textures[NB_TEXTURE_UNITS][NB_TEXTURE_TARGETS];
+    GLuint buffers[NB_BUFFER_TARGETS];
+    GLuint indexed_buffers[NB_INDEXED_BUFFER_TARGETS][NB_BUFFER_INDEXES];
+    GLuint read_framebuffer;
+    GLuint draw_framebuffer;
+    GLint viewport[4];
+    struct ngl_binding_stats stats;
+};
+
+static pthread_key_t current_bindings;
+static pthread_once_t current_bindings_once = PTHREAD_ONCE_INIT;
+
+static void create_bindings_key(void)
+{
+    int ret = pthread_key_create(&current_bindings, NULL);
+    ngli_assert(!ret);
+}
+
+static struct glbindings *get_current(void)
+{
+    pthread_once(&current_bindings_once, create_bindings_key);
+    return pthread_getspecific(current_bindings);
+}
+
+/*
+ * Every binding is set to UNKNOWN, which is not a valid object name, and the
+ * viewport to a negative size, so the next call is always issued.
+ */
+static void invalidate(struct glbindings *s)
+{
+    const struct ngl_binding_stats stats = s->stats;
+    memset(s, 0xff, sizeof(*s));
+    s->stats = stats;
+}
+
+struct glbindings *ngli_glbindings_create(void)
+{
+    struct glbindings *s = ngli_calloc(1, sizeof(*s));
+    if (!s)
+        return NULL;
+    invalidate(s);
+    return s;
+}
+
+void ngli_glbindings_set_current(struct glbindings *s)
+{
+    pthread_once(&current_bindings_once, create_bindings_key);
+    pthread_setspecific(current_bindings, s);
+    if (s)
+        invalidate(s);
+}
+
+void ngli_glbindings_invalidate(void)
+{
+    struct glbindings *s = get_current();
+    if (s)
+        invalidate(s);
+}
+
+void ngli_glbindings_get_stats(const struct glbindings *s, struct ngl_binding_stats *stats)
+{
+    *stats = s->stats;
+}
+
+void ngli_glbindings_freep(struct glbindings **sp)
+{
+    struct glbindings *s = *sp;
+    if (!s)
+        return;
+    if (get_current() == s)
+        pthread_setspecific(current_bindings, NULL);
+    ngli_free(s);
+    *sp = NULL;
+}
+
+static int issue(struct glbindings *s)
+{
+    if (s)
+        s->stats.issued++;
+    return 1;
+}
+
+static int update_binding(struct glbindings *s, GLuint *binding, GLuint id)
+{
+    if (*binding == id) {
+        s->stats.elided++;
+        return 0;
+    }
+    *binding = id;
+    s->stats.issued++;
+    return 1;
+}
+
+static void forget_bindings(GLuint *bindings, int nb_bindings, GLuint id)
+{
+    for (int i = 0; i < nb_bindings; i++)
+        if (bindings[i] == id)
+            bindings[i] = UNKNOWN;
+}
+
+static int get_texture_target_index(GLenum target)
+{
+    switch (target) {
+    case GL_TEXTURE_2D:           return TEXTURE_TARGET_2D;
+    case GL_TEXTURE_3D:           return TEXTURE_TARGET_3D;
+    case GL_TEXTURE_CUBE_MAP:     return TEXTURE_TARGET_CUBE_MAP;
+    case GL_TEXTURE_EXTERNAL_OES: return TEXTURE_TARGET_EXTERNAL_OES;
+    case GL_TEXTURE_RECTANGLE:    return TEXTURE_TARGET_RECTANGLE;
+    default:                      return -1;
+    }
+}
+
+static int get_buffer_target_index(GLenum target)
+{
+    switch (target) {
+    case GL_UNIFORM_BUFFER:        return BUFFER_TARGET_UNIFORM;
+    case GL_SHADER_STORAGE_BUFFER: return BUFFER_TARGET_SHADER_STORAGE;
+    case GL_ARRAY_BUFFER:          return BUFFER_TARGET_ARRAY;
+    case GL_ELEMENT_ARRAY_BUFFER:  return BUFFER_TARGET_ELEMENT_ARRAY;
+    default:                       return -1;
+    }
+}
+
+int ngli_glbindings_use_program(GLuint program)
+{
+    struct glbindings *s = get_current();
+    if (!s)
+        return 1;
+    return update_binding(s, &s->program, program);
+}
+
+int ngli_glbindings_bind_vertex_array(GLuint array)
+{
+    struct glbindings *s = get_current();
+    if (!s)
+        return 1;
+    if (!update_binding(s, &s->vertex_array, array))
+        return 0;
+
+    /* The element array buffer binding is part of the vertex array state */
+    s->buffers[BUFFER_TARGET_ELEMENT_ARRAY] = UNKNOWN;
+    return 1;
+}
+
+int ngli_glbindings_active_texture(GLenum texture)
+{
+    struct glbindings *s = get_current();
+    if (!s)
+        return 1;
+    const GLuint unit = texture - GL_TEXTURE0;
+    if (unit >= NB_TEXTURE_UNITS) {
+        s->active_texture = UNKNOWN;
+        return issue(s);
+    }
+    return update_binding(s, &s->active_texture, unit);
+}
+
+int ngli_glbindings_bind_texture(GLenum target, GLuint texture)
+{
+    struct glbindings *s = get_current();
+    if (!s)
+        return 1;
+    const int index = get_texture_target_index(target);
+    if (s->active_texture == UNKNOWN || index < 0)
+        return issue(s);
+    return update_binding(s, &s->textures[s->active_texture][index], texture);
+}
+
+int ngli_glbindings_bind_buffer(GLenum target, GLuint buffer)
+{
+    struct glbindings *s = get_current();
+    if (!s)
+        return 1;
+    const int index = get_buffer_target_index(target);
+    if (index < 0)
+        return issue(s);
+    return update_binding(s, &s->buffers[index], buffer);
+}
+
+int ngli_glbindings_bind_buffer_base(GLenum target, GLuint index, GLuint buffer)
+{
+    struct glbindings *s = get_current();
+    if (!s)
+        return 1;
+    const int target_index = get_buffer_target_index(target);
+    if (target_index < 0 || target_index >= NB_INDEXED_BUFFER_TARGETS || index >= NB_BUFFER_INDEXES)
+        return issue(s);
+
+    /* The buffer is also bound to the generic binding point of the target */
+    GLuint *indexed_binding = &s->indexed_buffers[target_index][index];
+    GLuint *binding = &s->buffers[target_index];
+    if (*indexed_binding == buffer && *binding == buffer) {
+        s->stats.elided++;
+        return 0;
+    }
+    *indexed_binding = buffer;
+    *binding = buffer;
+    return issue(s);
+}
+
+int ngli_glbindings_bind_buffer_range(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+{
+    struct glbindings *s = get_current();
+    if (!s)
+        return 1;
+    const int target_index = get_buffer_target_index(target);
+    if (target_index >= 0 && target_index < NB_INDEXED_BUFFER_TARGETS) {
+        s->buffers[target_index] = buffer;
+        if (index < NB_BUFFER_INDEXES)
+            s->indexed_buffers[target_index][index] = UNKNOWN;
+    }
+    return issue(s);
+}
+
+int ngli_glbindings_bind_framebuffer(GLenum target, GLuint framebuffer)
+{
+    struct glbindings *s = get_current();
+    if (!s)
+        return 1;
+
+    switch (target) {
+    case GL_FRAMEBUFFER:
+        if (s->read_framebuffer == framebuffer && s->draw_framebuffer == framebuffer) {
+            s->stats.elided++;
+            return 0;
+        }
+        s->read_framebuffer = framebuffer;
+        s->draw_framebuffer = framebuffer;
+        return issue(s);
+    case GL_READ_FRAMEBUFFER:
+        return update_binding(s, &s->read_framebuffer, framebuffer);
+    case GL_DRAW_FRAMEBUFFER:
+        return update_binding(s, &s->draw_framebuffer, framebuffer);
+    default:
+        return issue(s);
+    }
+}
+
+int ngli_glbindings_viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    struct glbindings *s = get_current();
+    if (!s)
+        return 1;
+    const GLint viewport[4] = {x, y, width, height};
+    if (!memcmp(s->viewport, viewport, sizeof(viewport))) {
+        s->stats.elided++;
+        return 0;
+    }
+    memcpy(s->viewport, viewport, sizeof(viewport));
+    return issue(s);
+}
+
+/*
+ * A deleted object is unbound from the current context, except for the
+ * current program which remains in use until another one is. In both cases
+ * the next binding of its name, which may be reused, must be issued.
+ */
+void ngli_glbindings_delete_program(GLuint program)
+{
+    struct glbindings *s = get_current();
+    if (!s || !program)
+        return;
+    forget_bindings(&s->program, 1, program);
+}
+
+void ngli_glbindings_delete_vertex_arrays(GLsizei n, const GLuint *arrays)
+{
+    struct glbindings *s = get_current();
+    if (!s)
+        return;
+    for (int i = 0; i < n; i++) {
+        if (!arrays[i] || s->vertex_array != arrays[i])
+            continue;
+        s->vertex_array = UNKNOWN;
+        s->buffers[BUFFER_TARGET_ELEMENT_ARRAY] = UNKNOWN;
+    }
+}
+
+void ngli_glbindings_delete_textures(GLsizei n, const GLuint *textures)
+{
+    struct glbindings *s = get_current();
+    if (!s)
+        return;
+    for (int i = 0; i < n; i++)
+        if (textures[i])
+            forget_bindings(&s->textures[0][0], NB_TEXTURE_UNITS * NB_TEXTURE_TARGETS, textures[i]);
+}
+
+void ngli_glbindings_delete_buffers(GLsizei n, const GLuint *buffers)
+{
+    struct glbindings *s = get_current();
+    if (!s)
+        return;
+    for (int i = 0; i < n; i++) {
+        if (!buffers[i])
+            continue;
+        forget_bindings(s->buffers, NB_BUFFER_TARGETS, buffers[i]);
+        forget_bindings(&s->indexed_buffers[0][0], NB_INDEXED_BUFFER_TARGETS * NB_BUFFER_INDEXES, buffers[i]);
+    }
+}
+
+void ngli_glbindings_delete_framebuffers(GLsizei n, const GLuint *framebuffers)
+{
+    struct glbindings *s = get_current();
+    if (!s)
+        return;
+    for (int i = 0; i < n; i++) {
+        if (!framebuffers[i])
+            continue;
+        forget_bindings(&s->read_framebuffer, 1, framebuffers[i]);
+        forget_bindings(&s->draw_framebuffer, 1, framebuffers[i]);
+    }
+}
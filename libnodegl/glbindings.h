@@ -0,0 +1,81 @@
+/*
+ * Copyright 2018 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#ifndef GLBINDINGS_H
+#define GLBINDINGS_H
+
+#include "glincludes.h"
+#include "nodegl.h"
+
+/*
+ * Shadow of the object bindings of a GL context (program, vertex array,
+ * textures, buffers, framebuffers and viewport), used by the ngli_gl*
+ * wrappers to skip the calls which would not change anything.
+ *
+ * The bindings are GL context state, so the shadow consulted is the one of
+ * the context current on the calling thread, as set by
+ * ngli_glcontext_make_current(). Without current shadow, or for targets and
+ * units which are not tracked, every call is issued.
+ */
+struct glbindings;
+
+struct glbindings *ngli_glbindings_create(void);
+
+/*
+ * Set the shadow of the context made current on the calling thread (NULL if
+ * none). The shadow is invalidated since the state may have been changed
+ * while the context was not current.
+ */
+void ngli_glbindings_set_current(struct glbindings *s);
+
+/*
+ * Forget the bindings of the current context, typically after calling an
+ * external API binding objects on its own.
+ */
+void ngli_glbindings_invalidate(void);
+
+void ngli_glbindings_get_stats(const struct glbindings *s, struct ngl_binding_stats *stats);
+void ngli_glbindings_freep(struct glbindings **sp);
+
+/*
+ * Hooks of the ngli_gl* wrappers: the binding ones return 0 if the call can
+ * be skipped, the deletion ones forget the bindings of the deleted objects.
+ * Only the shadow of the current context is updated on deletion: the contexts
+ * sharing the objects must be invalidated before binding them again.
+ */
+int ngli_glbindings_use_program(GLuint program);
+int ngli_glbindings_bind_vertex_array(GLuint array);
+int ngli_glbindings_active_texture(GLenum texture);
+int ngli_glbindings_bind_texture(GLenum target, GLuint texture);
+int ngli_glbindings_bind_buffer(GLenum target, GLuint buffer);
+int ngli_glbindings_bind_buffer_base(GLenum target, GLuint index, GLuint buffer);
+int ngli_glbindings_bind_buffer_range(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+int ngli_glbindings_bind_framebuffer(GLenum target, GLuint framebuffer);
+int ngli_glbindings_viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+void ngli_glbindings_delete_program(GLuint program);
+void ngli_glbindings_delete_vertex_arrays(GLsizei n, const GLuint *arrays);
+void ngli_glbindings_delete_textures(GLsizei n, const GLuint *textures);
+void ngli_glbindings_delete_buffers(GLsizei n, const GLuint *buffers);
+void ngli_glbindings_delete_framebuffers(GLsizei n, const GLuint *framebuffers);
+
+#endif /* GLBINDINGS_H */
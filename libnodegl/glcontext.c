@@ -324,7 +324,7 @@ static int glcontext_load_extensions(struct glcontext *glcontext)
     return 0;
 }
 
-struct glcontext *ngli_glcontext_new(const struct ngl_config *config)
+static struct glcontext *glcontext_new(const struct ngl_config *config, int shared)
 {
     if (config->platform < 0 || config->platform >= NGLI_ARRAY_NB(platform_to_glplatform))
         return NULL;
@@ -337,10 +337,18 @@ struct glcontext *ngli_glcontext_new(const struct ngl_config *config)
     if (!glcontext)
         return NULL;
     glcontext->class = glcontext_class_map[glplatform];
+    glcontext->shared = shared;
+
+    glcontext->bindings = ngli_glbindings_create();
+    if (!glcontext->bindings) {
+        ngli_free(glcontext);
+        return NULL;
+    }
 
     if (glcontext->class->priv_size) {
         glcontext->priv_data = ngli_calloc(1, glcontext->class->priv_size);
         if (!glcontext->priv_data) {
+            ngli_glbindings_freep(&glcontext->bindings);
             ngli_free(glcontext);
             return NULL;
         }
@@ -380,11 +388,46 @@ fail:
     return NULL;
 }
 
+struct glcontext *ngli_glcontext_new(const struct ngl_config *config)
+{
+    return glcontext_new(config, 0);
+}
+
+/*
+ * Create an offscreen context sharing its objects (textures, buffers,
+ * programs, sync objects, ...) with another context, and make it current on
+ * the calling thread. Container objects such as framebuffers and vertex
+ * arrays are not shared.
+ */
+struct glcontext *ngli_glcontext_new_shared(struct glcontext *other)
+{
+    const uintptr_t handle = ngli_glcontext_get_handle(other);
+    if (!handle) {
+        LOG(ERROR, "context does not expose a handle to share with");
+        return NULL;
+    }
+
+    const struct ngl_config config = {
+        .platform  = other->platform,
+        .backend   = other->backend,
+        .display   = ngli_glcontext_get_display(other),
+        .handle    = handle,
+        .offscreen = 1,
+        .width     = 1,
+        .height    = 1,
+    };
+    return glcontext_new(&config, 1);
+}
+
 int ngli_glcontext_make_current(struct glcontext *glcontext, int current)
 {
-    if (glcontext->class->make_current)
-        return glcontext->class->make_current(glcontext, current);
+    if (glcontext->class->make_current) {
+        int ret = glcontext->class->make_current(glcontext, current);
+        if (ret < 0)
+            return ret;
+    }
 
+    ngli_glbindings_set_current(current ? glcontext->bindings : NULL);
     return 0;
 }
 
@@ -433,6 +476,7 @@ void ngli_glcontext_freep(struct glcontext **glcontextp)
     if (glcontext->class->uninit)
         glcontext->class->uninit(glcontext);
 
+    ngli_glbindings_freep(&glcontext->bindings);
     ngli_free(glcontext->priv_data);
     ngli_free(glcontext);
 
@@ -23,6 +23,7 @@
 #define GLCONTEXT_H
 
 #include <stdlib.h>
+#include "glbindings.h"
 #include "glfunctions.h"
 #include "nodegl.h"
 
@@ -50,6 +51,8 @@
 #define NGLI_FEATURE_EGL_EXT_IMAGE_DMA_BUF_IMPORT (1 << 21)
 #define NGLI_FEATURE_SYNC                         (1 << 22)
 #define NGLI_FEATURE_YUV_TARGET                   (1 << 23)
+#define NGLI_FEATURE_KHR_PARALLEL_SHADER_COMPILE  (1 << 24)
+#define NGLI_FEATURE_PROGRAM_BINARY               (1 << 25)
 
 #define NGLI_FEATURE_COMPUTE_SHADER_ALL (NGLI_FEATURE_COMPUTE_SHADER           | \
                                          NGLI_FEATURE_PROGRAM_INTERFACE_QUERY  | \
@@ -62,6 +65,10 @@ struct glcontext {
     /* GL context */
     const struct glcontext_class *class;
     void *priv_data;
+    int shared; /* created with ngli_glcontext_new_shared() */
+    struct ngl_memory_stats memstats;
+    struct ngl_uniform_stats uniform_stats; /* see ngli_program_upload_uniform() */
+    struct glbindings *bindings;
 
     /* User options */
     int platform;
@@ -104,6 +111,7 @@ struct glcontext_class {
 };
 
 struct glcontext *ngli_glcontext_new(const struct ngl_config *config);
+struct glcontext *ngli_glcontext_new_shared(struct glcontext *other);
 int ngli_glcontext_make_current(struct glcontext *glcontext, int current);
 void ngli_glcontext_swap_buffers(struct glcontext *glcontext);
 int ngli_glcontext_set_swap_interval(struct glcontext *glcontext, int interval);
@@ -339,7 +339,8 @@ static void egl_uninit(struct glcontext *ctx)
     if (egl->handle)
         eglDestroyContext(egl->display, egl->handle);
 
-    if (egl->display)
+    /* The display is owned by the context we are sharing the objects with */
+    if (egl->display && !ctx->shared)
         eglTerminate(egl->display);
 
 #if defined(TARGET_LINUX)
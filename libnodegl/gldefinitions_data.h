@@ -50,6 +50,7 @@ static const struct gldefinition {
     {"glDeleteQueriesEXT", offsetof(struct glfunctions, DeleteQueriesEXT), 0},
     {"glDeleteRenderbuffers", offsetof(struct glfunctions, DeleteRenderbuffers), M},
     {"glDeleteShader", offsetof(struct glfunctions, DeleteShader), M},
+    {"glDeleteSync", offsetof(struct glfunctions, DeleteSync), 0},
     {"glDeleteTextures", offsetof(struct glfunctions, DeleteTextures), M},
     {"glDeleteVertexArrays", offsetof(struct glfunctions, DeleteVertexArrays), 0},
     {"glDepthFunc", offsetof(struct glfunctions, DepthFunc), M},
@@ -68,6 +69,7 @@ static const struct gldefinition {
     {"glEndQuery", offsetof(struct glfunctions, EndQuery), 0},
     {"glEndQueryEXT", offsetof(struct glfunctions, EndQueryEXT), 0},
     {"glFenceSync", offsetof(struct glfunctions, FenceSync), 0},
+    {"glFlush", offsetof(struct glfunctions, Flush), M},
     {"glFramebufferRenderbuffer", offsetof(struct glfunctions, FramebufferRenderbuffer), M},
     {"glFramebufferTexture2D", offsetof(struct glfunctions, FramebufferTexture2D), M},
     {"glGenBuffers", offsetof(struct glfunctions, GenBuffers), M},
@@ -82,6 +84,7 @@ static const struct gldefinition {
     {"glGetActiveUniform", offsetof(struct glfunctions, GetActiveUniform), M},
     {"glGetActiveUniformBlockName", offsetof(struct glfunctions, GetActiveUniformBlockName), 0},
     {"glGetActiveUniformBlockiv", offsetof(struct glfunctions, GetActiveUniformBlockiv), 0},
+    {"glGetActiveUniformsiv", offsetof(struct glfunctions, GetActiveUniformsiv), 0},
     {"glGetAttachedShaders", offsetof(struct glfunctions, GetAttachedShaders), M},
     {"glGetAttribLocation", offsetof(struct glfunctions, GetAttribLocation), M},
     {"glGetBooleanv", offsetof(struct glfunctions, GetBooleanv), M},
@@ -89,6 +92,7 @@ static const struct gldefinition {
     {"glGetIntegeri_v", offsetof(struct glfunctions, GetIntegeri_v), M},
     {"glGetIntegerv", offsetof(struct glfunctions, GetIntegerv), M},
     {"glGetInternalformativ", offsetof(struct glfunctions, GetInternalformativ), 0},
+    {"glGetProgramBinary", offsetof(struct glfunctions, GetProgramBinary), 0},
     {"glGetProgramInfoLog", offsetof(struct glfunctions, GetProgramInfoLog), M},
     {"glGetProgramInterfaceiv", offsetof(struct glfunctions, GetProgramInterfaceiv), 0},
     {"glGetProgramResourceIndex", offsetof(struct glfunctions, GetProgramResourceIndex), 0},
@@ -109,8 +113,11 @@ static const struct gldefinition {
     {"glGetUniformiv", offsetof(struct glfunctions, GetUniformiv), M},
     {"glInvalidateFramebuffer", offsetof(struct glfunctions, InvalidateFramebuffer), 0},
     {"glLinkProgram", offsetof(struct glfunctions, LinkProgram), M},
+    {"glMaxShaderCompilerThreadsKHR", offsetof(struct glfunctions, MaxShaderCompilerThreadsKHR), 0},
     {"glMemoryBarrier", offsetof(struct glfunctions, MemoryBarrier), 0},
     {"glPolygonMode", offsetof(struct glfunctions, PolygonMode), 0},
+    {"glProgramBinary", offsetof(struct glfunctions, ProgramBinary), 0},
+    {"glProgramParameteri", offsetof(struct glfunctions, ProgramParameteri), 0},
     {"glReadPixels", offsetof(struct glfunctions, ReadPixels), M},
     {"glReleaseShaderCompiler", offsetof(struct glfunctions, ReleaseShaderCompiler), M},
     {"glRenderbufferStorage", offsetof(struct glfunctions, RenderbufferStorage), M},
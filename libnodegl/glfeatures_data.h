@@ -163,6 +163,7 @@ static const struct glfeature {
                                            OFFSET(UniformBlockBinding),
                                            OFFSET(GetActiveUniformBlockName),
                                            OFFSET(GetActiveUniformBlockiv),
+                                           OFFSET(GetActiveUniformsiv),
                                            -1}
     }, {
         .name           = "invalidate_subdata",
@@ -208,10 +209,28 @@ static const struct glfeature {
         .funcs_offsets  = (const size_t[]){OFFSET(FenceSync),
                                            OFFSET(ClientWaitSync),
                                            OFFSET(WaitSync),
+                                           OFFSET(DeleteSync),
                                            -1}
     }, {
         .name           = "yuv_target",
         .flag           = NGLI_FEATURE_YUV_TARGET,
         .es_extensions  = (const char*[]){"GL_EXT_YUV_target", NULL}
+    }, {
+        .name           = "khr_parallel_shader_compile",
+        .flag           = NGLI_FEATURE_KHR_PARALLEL_SHADER_COMPILE,
+        .extensions     = (const char*[]){"GL_KHR_parallel_shader_compile", NULL},
+        .es_extensions  = (const char*[]){"GL_KHR_parallel_shader_compile", NULL},
+        .funcs_offsets  = (const size_t[]){OFFSET(MaxShaderCompilerThreadsKHR),
+                                           -1}
+    }, {
+        .name           = "program_binary",
+        .flag           = NGLI_FEATURE_PROGRAM_BINARY,
+        .version        = 410,
+        .es_version     = 300,
+        .extensions     = (const char*[]){"GL_ARB_get_program_binary", NULL},
+        .funcs_offsets  = (const size_t[]){OFFSET(GetProgramBinary),
+                                           OFFSET(ProgramBinary),
+                                           OFFSET(ProgramParameteri),
+                                           -1}
     }
 };
@@ -182,6 +182,14 @@ typedef void* GLeglImageOES;
 # define GL_UNIFORM_BUFFER                     0x8A11
 # define GL_UNIFORM_BLOCK_BINDING              0x8A3F
 # define GL_MAX_UNIFORM_BLOCK_SIZE             0x8A30
+# define GL_UNIFORM_BLOCK_INDEX                0x8A3A
+# define GL_UNIFORM_OFFSET                     0x8A3B
+# define GL_UNIFORM_ARRAY_STRIDE               0x8A3C
+# define GL_UNIFORM_MATRIX_STRIDE              0x8A3D
+# define GL_UNIFORM_BLOCK_DATA_SIZE            0x8A40
+# define GL_PROGRAM_BINARY_RETRIEVABLE_HINT    0x8257
+# define GL_PROGRAM_BINARY_LENGTH              0x8741
+# define GL_NUM_PROGRAM_BINARY_FORMATS         0x87FE
 #endif
 
 #if NGL_CS_COMPAT_INCLUDES
@@ -10,6 +10,8 @@
 
 static inline void ngli_glActiveTexture(const struct glcontext *gl, GLenum texture)
 {
+    if (!ngli_glbindings_active_texture(texture))
+        return;
     gl->funcs.ActiveTexture(texture);
     check_error_code(gl, "glActiveTexture");
 }
@@ -40,24 +42,32 @@ static inline void ngli_glBindAttribLocation(const struct glcontext *gl, GLuint
 
 static inline void ngli_glBindBuffer(const struct glcontext *gl, GLenum target, GLuint buffer)
 {
+    if (!ngli_glbindings_bind_buffer(target, buffer))
+        return;
     gl->funcs.BindBuffer(target, buffer);
     check_error_code(gl, "glBindBuffer");
 }
 
 static inline void ngli_glBindBufferBase(const struct glcontext *gl, GLenum target, GLuint index, GLuint buffer)
 {
+    if (!ngli_glbindings_bind_buffer_base(target, index, buffer))
+        return;
     gl->funcs.BindBufferBase(target, index, buffer);
     check_error_code(gl, "glBindBufferBase");
 }
 
 static inline void ngli_glBindBufferRange(const struct glcontext *gl, GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size)
 {
+    if (!ngli_glbindings_bind_buffer_range(target, index, buffer, offset, size))
+        return;
     gl->funcs.BindBufferRange(target, index, buffer, offset, size);
     check_error_code(gl, "glBindBufferRange");
 }
 
 static inline void ngli_glBindFramebuffer(const struct glcontext *gl, GLenum target, GLuint framebuffer)
 {
+    if (!ngli_glbindings_bind_framebuffer(target, framebuffer))
+        return;
     gl->funcs.BindFramebuffer(target, framebuffer);
     check_error_code(gl, "glBindFramebuffer");
 }
@@ -76,12 +86,16 @@ static inline void ngli_glBindRenderbuffer(const struct glcontext *gl, GLenum ta
 
 static inline void ngli_glBindTexture(const struct glcontext *gl, GLenum target, GLuint texture)
 {
+    if (!ngli_glbindings_bind_texture(target, texture))
+        return;
     gl->funcs.BindTexture(target, texture);
     check_error_code(gl, "glBindTexture");
 }
 
 static inline void ngli_glBindVertexArray(const struct glcontext *gl, GLuint array)
 {
+    if (!ngli_glbindings_bind_vertex_array(array))
+        return;
     gl->funcs.BindVertexArray(array);
     check_error_code(gl, "glBindVertexArray");
 }
@@ -194,18 +208,21 @@ static inline void ngli_glCullFace(const struct glcontext *gl, GLenum mode)
 
 static inline void ngli_glDeleteBuffers(const struct glcontext *gl, GLsizei n, const GLuint * buffers)
 {
+    ngli_glbindings_delete_buffers(n, buffers);
     gl->funcs.DeleteBuffers(n, buffers);
     check_error_code(gl, "glDeleteBuffers");
 }
 
 static inline void ngli_glDeleteFramebuffers(const struct glcontext *gl, GLsizei n, const GLuint * framebuffers)
 {
+    ngli_glbindings_delete_framebuffers(n, framebuffers);
     gl->funcs.DeleteFramebuffers(n, framebuffers);
     check_error_code(gl, "glDeleteFramebuffers");
 }
 
 static inline void ngli_glDeleteProgram(const struct glcontext *gl, GLuint program)
 {
+    ngli_glbindings_delete_program(program);
     gl->funcs.DeleteProgram(program);
     check_error_code(gl, "glDeleteProgram");
 }
@@ -234,14 +251,22 @@ static inline void ngli_glDeleteShader(const struct glcontext *gl, GLuint shader
     check_error_code(gl, "glDeleteShader");
 }
 
+static inline void ngli_glDeleteSync(const struct glcontext *gl, GLsync sync)
+{
+    gl->funcs.DeleteSync(sync);
+    check_error_code(gl, "glDeleteSync");
+}
+
 static inline void ngli_glDeleteTextures(const struct glcontext *gl, GLsizei n, const GLuint * textures)
 {
+    ngli_glbindings_delete_textures(n, textures);
     gl->funcs.DeleteTextures(n, textures);
     check_error_code(gl, "glDeleteTextures");
 }
 
 static inline void ngli_glDeleteVertexArrays(const struct glcontext *gl, GLsizei n, const GLuint * arrays)
 {
+    ngli_glbindings_delete_vertex_arrays(n, arrays);
     gl->funcs.DeleteVertexArrays(n, arrays);
     check_error_code(gl, "glDeleteVertexArrays");
 }
@@ -343,6 +368,12 @@ static inline GLsync ngli_glFenceSync(const struct glcontext *gl, GLenum conditi
     return ret;
 }
 
+static inline void ngli_glFlush(const struct glcontext *gl)
+{
+    gl->funcs.Flush();
+    check_error_code(gl, "glFlush");
+}
+
 static inline void ngli_glFramebufferRenderbuffer(const struct glcontext *gl, GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer)
 {
     gl->funcs.FramebufferRenderbuffer(target, attachment, renderbuffertarget, renderbuffer);
@@ -427,6 +458,12 @@ static inline void ngli_glGetActiveUniformBlockiv(const struct glcontext *gl, GL
     check_error_code(gl, "glGetActiveUniformBlockiv");
 }
 
+static inline void ngli_glGetActiveUniformsiv(const struct glcontext *gl, GLuint program, GLsizei uniformCount, const GLuint * uniformIndices, GLenum pname, GLint * params)
+{
+    gl->funcs.GetActiveUniformsiv(program, uniformCount, uniformIndices, pname, params);
+    check_error_code(gl, "glGetActiveUniformsiv");
+}
+
 static inline void ngli_glGetAttachedShaders(const struct glcontext *gl, GLuint program, GLsizei maxCount, GLsizei * count, GLuint * shaders)
 {
     gl->funcs.GetAttachedShaders(program, maxCount, count, shaders);
@@ -469,6 +506,12 @@ static inline void ngli_glGetInternalformativ(const struct glcontext *gl, GLenum
     check_error_code(gl, "glGetInternalformativ");
 }
 
+static inline void ngli_glGetProgramBinary(const struct glcontext *gl, GLuint program, GLsizei bufSize, GLsizei * length, GLenum * binaryFormat, void * binary)
+{
+    gl->funcs.GetProgramBinary(program, bufSize, length, binaryFormat, binary);
+    check_error_code(gl, "glGetProgramBinary");
+}
+
 static inline void ngli_glGetProgramInfoLog(const struct glcontext *gl, GLuint program, GLsizei bufSize, GLsizei * length, GLchar * infoLog)
 {
     gl->funcs.GetProgramInfoLog(program, bufSize, length, infoLog);
@@ -595,6 +638,12 @@ static inline void ngli_glLinkProgram(const struct glcontext *gl, GLuint program
     check_error_code(gl, "glLinkProgram");
 }
 
+static inline void ngli_glMaxShaderCompilerThreadsKHR(const struct glcontext *gl, GLuint count)
+{
+    gl->funcs.MaxShaderCompilerThreadsKHR(count);
+    check_error_code(gl, "glMaxShaderCompilerThreadsKHR");
+}
+
 static inline void ngli_glMemoryBarrier(const struct glcontext *gl, GLbitfield barriers)
 {
     gl->funcs.MemoryBarrier(barriers);
@@ -607,6 +656,18 @@ static inline void ngli_glPolygonMode(const struct glcontext *gl, GLenum face, G
     check_error_code(gl, "glPolygonMode");
 }
 
+static inline void ngli_glProgramBinary(const struct glcontext *gl, GLuint program, GLenum binaryFormat, const void * binary, GLsizei length)
+{
+    gl->funcs.ProgramBinary(program, binaryFormat, binary, length);
+    check_error_code(gl, "glProgramBinary");
+}
+
+static inline void ngli_glProgramParameteri(const struct glcontext *gl, GLuint program, GLenum pname, GLint value)
+{
+    gl->funcs.ProgramParameteri(program, pname, value);
+    check_error_code(gl, "glProgramParameteri");
+}
+
 static inline void ngli_glReadPixels(const struct glcontext *gl, GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, void * pixels)
 {
     gl->funcs.ReadPixels(x, y, width, height, format, type, pixels);
@@ -843,6 +904,8 @@ static inline void ngli_glUniformMatrix4fv(const struct glcontext *gl, GLint loc
 
 static inline void ngli_glUseProgram(const struct glcontext *gl, GLuint program)
 {
+    if (!ngli_glbindings_use_program(program))
+        return;
     gl->funcs.UseProgram(program);
     check_error_code(gl, "glUseProgram");
 }
@@ -861,6 +924,8 @@ static inline void ngli_glVertexAttribPointer(const struct glcontext *gl, GLuint
 
 static inline void ngli_glViewport(const struct glcontext *gl, GLint x, GLint y, GLsizei width, GLsizei height)
 {
+    if (!ngli_glbindings_viewport(x, y, width, height))
+        return;
     gl->funcs.Viewport(x, y, width, height);
     check_error_code(gl, "glViewport");
 }
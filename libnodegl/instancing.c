@@ -0,0 +1,307 @@
+/*
+ * Copyright 2018 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bstr.h"
+#include "instancing.h"
+#include "memory.h"
+#include "utils.h"
+
+#define MAX_TOKEN_LEN 64
+
+struct decl {
+    const char *start;  /* "uniform" keyword */
+    const char *end;    /* right after the ';' */
+    char precision[MAX_TOKEN_LEN + 1]; /* token followed by a space */
+    char type[MAX_TOKEN_LEN];
+};
+
+static int is_ident_char(char c)
+{
+    return isalnum((unsigned char)c) || c == '_';
+}
+
+static const char *skip_spaces(const char *p)
+{
+    while (isspace((unsigned char)*p))
+        p++;
+    return p;
+}
+
+/* Find the next occurrence of word in src, starting at p, as a whole identifier */
+static const char *find_token(const char *src, const char *p, const char *word)
+{
+    const size_t len = strlen(word);
+    for (; (p = strstr(p, word)); p += len)
+        if ((p == src || !is_ident_char(p[-1])) && !is_ident_char(p[len]))
+            return p;
+    return NULL;
+}
+
+/* Read the identifier at p into buf and return the position after it */
+static const char *read_token(const char *p, char *buf, size_t size)
+{
+    size_t len = 0;
+    while (is_ident_char(p[len]))
+        len++;
+    if (!len || len >= size)
+        return NULL;
+    memcpy(buf, p, len);
+    buf[len] = 0;
+    return p + len;
+}
+
+/*
+ * Look for the "uniform [precision] <type> <name>;" declaration of name;
+ * array and multiple declarations are not recognized.
+ */
+static int find_uniform_decl(const char *src, const char *name, struct decl *decl)
+{
+    const char *p = src;
+    while ((p = find_token(src, p, "uniform"))) {
+        const char *start = p;
+        char tokens[3][MAX_TOKEN_LEN];
+        int nb_tokens = 0;
+
+        p += strlen("uniform");
+        for (;;) {
+            p = skip_spaces(p);
+            if (*p == ';' || nb_tokens == NGLI_ARRAY_NB(tokens))
+                break;
+            const char *next = read_token(p, tokens[nb_tokens], sizeof(tokens[nb_tokens]));
+            if (!next)
+                break;
+            nb_tokens++;
+            p = next;
+        }
+
+        if (*p != ';' || nb_tokens < 2 || strcmp(tokens[nb_tokens - 1], name))
+            continue;
+
+        if (nb_tokens == 3) {
+            if (strcmp(tokens[0], "lowp") && strcmp(tokens[0], "mediump") && strcmp(tokens[0], "highp"))
+                continue;
+            snprintf(decl->precision, sizeof(decl->precision), "%s ", tokens[0]);
+        } else {
+            decl->precision[0] = 0;
+        }
+        memcpy(decl->type, tokens[nb_tokens - 2], sizeof(decl->type));
+        decl->start = start;
+        decl->end = p + 1;
+        return 1;
+    }
+    return 0;
+}
+
+/* Whether the shader uses the in/out qualifiers instead of attribute/varying */
+static int has_in_out(const char *src)
+{
+    const char *p = strstr(src, "#version");
+    if (!p)
+        return 0;
+    char *end;
+    const long version = strtol(p + strlen("#version"), &end, 10);
+    const char *profile = skip_spaces(end);
+    if (!strncmp(profile, "es", 2) && !is_ident_char(profile[2]))
+        return version >= 300;
+    return version >= 130;
+}
+
+/* Replace the [start,end) segment of *srcp (allocated) with repl */
+static int replace(char **srcp, const char *start, const char *end, const char *repl)
+{
+    char *src = *srcp;
+    char *dst = ngli_asprintf("%.*s%s%s", (int)(start - src), src, repl, end);
+    if (!dst)
+        return -1;
+    ngli_free(src);
+    *srcp = dst;
+    return 0;
+}
+
+/* Turn the uniform declaration of name into "<qualifier><precision><type> <name>;" */
+static int replace_decl(char **srcp, const struct decl *decl, const char *qualifier, const char *name)
+{
+    char *repl = ngli_asprintf("%s%s%s %s;", qualifier, decl->precision, decl->type, name);
+    if (!repl)
+        return -1;
+    int ret = replace(srcp, decl->start, decl->end, repl);
+    ngli_free(repl);
+    return ret;
+}
+
+/* Make a builtin matrix uniform of the vertex shader a global variable */
+static int rewrite_builtin(char **vertexp, const char *name, const char *type)
+{
+    if (!find_token(*vertexp, *vertexp, name))
+        return 0;
+    struct decl decl;
+    if (!find_uniform_decl(*vertexp, name, &decl) || strcmp(decl.type, type))
+        return 1;
+    int ret = replace_decl(vertexp, &decl, "", name);
+    return ret < 0 ? ret : 2;
+}
+
+static int rename_main(char **vertexp)
+{
+    const char *main_func = NULL;
+    const char *p = *vertexp;
+    while ((p = find_token(*vertexp, p, "main"))) {
+        if (*skip_spaces(p + strlen("main")) == '(') {
+            if (main_func)
+                return 1;
+            main_func = p;
+        }
+        p += strlen("main");
+    }
+    if (!main_func)
+        return 1;
+    return replace(vertexp, main_func, main_func + strlen("main"), "ngli_main");
+}
+
+static int rewrite(struct instancing_shaders *s, struct instancing_var *vars, int nb_vars)
+{
+    const int vert_in_out = has_in_out(s->vertex);
+    const int frag_in_out = has_in_out(s->fragment);
+    const char *attribute = vert_in_out ? "in " : "attribute ";
+    const char *vert_varying = vert_in_out ? "out " : "varying ";
+    const char *frag_varying = frag_in_out ? "in " : "varying ";
+
+    /* The matrices are computed per instance in the vertex shader only */
+    if (find_token(s->fragment, s->fragment, "ngl_modelview_matrix") ||
+        find_token(s->fragment, s->fragment, "ngl_normal_matrix"))
+        return 1;
+
+    int ret = rename_main(&s->vertex);
+    if (ret)
+        return ret;
+
+    if ((ret = rewrite_builtin(&s->vertex, "ngl_modelview_matrix", "mat4")) < 0 || ret == 1)
+        return ret;
+    s->has_modelview = ret == 2;
+
+    if ((ret = rewrite_builtin(&s->vertex, "ngl_normal_matrix", "mat3")) < 0 || ret == 1)
+        return ret;
+    s->has_normal = ret == 2;
+
+    struct bstr *decls = ngli_bstr_create();
+    struct bstr *body = ngli_bstr_create();
+    if (!decls || !body) {
+        ret = -1;
+        goto end;
+    }
+
+    ngli_bstr_print(body, "void main()\n{\n");
+
+    if (s->has_modelview) {
+        for (int i = 0; i < 4; i++)
+            ngli_bstr_print(decls, "%svec4 " NGLI_INSTANCING_MODELVIEW_FMT ";\n", attribute, i);
+        ngli_bstr_print(body, "    ngl_modelview_matrix = mat4(");
+        for (int i = 0; i < 4; i++)
+            ngli_bstr_print(body, "%s" NGLI_INSTANCING_MODELVIEW_FMT, i ? ", " : "", i);
+        ngli_bstr_print(body, ");\n");
+    }
+
+    if (s->has_normal) {
+        for (int i = 0; i < 3; i++)
+            ngli_bstr_print(decls, "%svec3 " NGLI_INSTANCING_NORMAL_FMT ";\n", attribute, i);
+        ngli_bstr_print(body, "    ngl_normal_matrix = mat3(");
+        for (int i = 0; i < 3; i++)
+            ngli_bstr_print(body, "%s" NGLI_INSTANCING_NORMAL_FMT, i ? ", " : "", i);
+        ngli_bstr_print(body, ");\n");
+    }
+
+    for (int i = 0; i < nb_vars; i++) {
+        struct instancing_var *var = &vars[i];
+        struct decl vdecl, fdecl;
+        const int in_vertex = find_uniform_decl(s->vertex, var->name, &vdecl);
+        const int in_fragment = find_uniform_decl(s->fragment, var->name, &fdecl);
+
+        if ((in_vertex && strcmp(vdecl.type, var->type)) ||
+            (in_fragment && strcmp(fdecl.type, var->type))) {
+            ret = 1;
+            goto end;
+        }
+
+        var->used = in_vertex || in_fragment;
+        if (!var->used)
+            continue;
+
+        /* The values reach the fragment shader through a varying */
+        if (in_fragment) {
+            if ((ret = replace_decl(&s->fragment, &fdecl, frag_varying, var->name)) < 0)
+                goto end;
+            if (!in_vertex)
+                ngli_bstr_print(decls, "%s%s%s %s;\n", vert_varying, fdecl.precision, var->type, var->name);
+        }
+        if (in_vertex &&
+            (ret = replace_decl(&s->vertex, &vdecl, in_fragment ? vert_varying : "", var->name)) < 0)
+            goto end;
+
+        ngli_bstr_print(decls, "%s%s " NGLI_INSTANCING_VAR_FMT ";\n", attribute, var->type, var->name);
+        ngli_bstr_print(body, "    %s = " NGLI_INSTANCING_VAR_FMT ";\n", var->name, var->name);
+    }
+
+    ngli_bstr_print(body, "    ngli_main();\n}\n");
+
+    char *vertex = ngli_asprintf("%s\n%s%s", s->vertex, ngli_bstr_strptr(decls), ngli_bstr_strptr(body));
+    if (!vertex) {
+        ret = -1;
+        goto end;
+    }
+    ngli_free(s->vertex);
+    s->vertex = vertex;
+    ret = 0;
+
+end:
+    ngli_bstr_freep(&decls);
+    ngli_bstr_freep(&body);
+    return ret;
+}
+
+int ngli_instancing_rewrite(struct instancing_shaders *s, const char *vertex, const char *fragment,
+                            struct instancing_var *vars, int nb_vars)
+{
+    memset(s, 0, sizeof(*s));
+
+    s->vertex = ngli_strdup(vertex);
+    s->fragment = ngli_strdup(fragment);
+    if (!s->vertex || !s->fragment) {
+        ngli_instancing_reset(s);
+        return -1;
+    }
+
+    int ret = rewrite(s, vars, nb_vars);
+    if (ret)
+        ngli_instancing_reset(s);
+    return ret;
+}
+
+void ngli_instancing_reset(struct instancing_shaders *s)
+{
+    ngli_free(s->vertex);
+    ngli_free(s->fragment);
+    memset(s, 0, sizeof(*s));
+}
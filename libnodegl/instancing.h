@@ -0,0 +1,58 @@
+/*
+ * Copyright 2018 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#ifndef INSTANCING_H
+#define INSTANCING_H
+
+#define NGLI_INSTANCING_MAX_VARS 8
+
+/* Names of the per instance attributes of the rewritten vertex shader */
+#define NGLI_INSTANCING_MODELVIEW_FMT "ngli_instance_modelview_%d" /* 4 vec4 columns */
+#define NGLI_INSTANCING_NORMAL_FMT    "ngli_instance_normal_%d"    /* 3 vec3 columns */
+#define NGLI_INSTANCING_VAR_FMT       "ngli_instance_%s"
+
+/* Uniform turned into a per instance value */
+struct instancing_var {
+    const char *name;
+    const char *type; /* GLSL type: float, vec2, vec3 or vec4 */
+    int used;         /* set if any of the shaders declares it */
+};
+
+struct instancing_shaders {
+    char *vertex;
+    char *fragment;
+    int has_modelview;
+    int has_normal;
+};
+
+/*
+ * Rewrite the shaders of a program so that the modelview and normal matrices
+ * as well as the given uniforms are read from per instance attributes
+ * instead. Return 0 on success, 1 if the shaders cannot be rewritten (the
+ * program must then be used as is), and a negative value on error.
+ */
+int ngli_instancing_rewrite(struct instancing_shaders *s, const char *vertex, const char *fragment,
+                            struct instancing_var *vars, int nb_vars);
+
+void ngli_instancing_reset(struct instancing_shaders *s);
+
+#endif
@@ -0,0 +1,84 @@
+/*
+ * Copyright 2018 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <pthread.h>
+#include <string.h>
+
+#include "memstats.h"
+#include "utils.h"
+
+static pthread_key_t current_owner;
+static pthread_once_t current_owner_once = PTHREAD_ONCE_INIT;
+
+static void create_owner_key(void)
+{
+    int ret = pthread_key_create(&current_owner, NULL);
+    ngli_assert(!ret);
+}
+
+struct ngl_memory_stats *ngli_memstats_set_owner(struct ngl_memory_stats *owner)
+{
+    pthread_once(&current_owner_once, create_owner_key);
+    struct ngl_memory_stats *prev = pthread_getspecific(current_owner);
+    pthread_setspecific(current_owner, owner);
+    return prev;
+}
+
+static void stats_add(struct ngl_memory_stats *stats, int category, int64_t size, int count)
+{
+    if (!stats)
+        return;
+    __atomic_add_fetch(&stats->sizes[category], size, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&stats->counts[category], count, __ATOMIC_RELAXED);
+}
+
+void ngli_memstats_add(struct memstats_entry *entry, struct ngl_memory_stats *ctx_stats,
+                       int category, int64_t size)
+{
+    ngli_assert(category >= 0 && category < NGL_NB_MEMORY);
+
+    pthread_once(&current_owner_once, create_owner_key);
+    entry->ctx_stats = ctx_stats;
+    entry->node_stats = pthread_getspecific(current_owner);
+    entry->category = category;
+    entry->size = size;
+
+    stats_add(entry->ctx_stats, category, size, 1);
+    stats_add(entry->node_stats, category, size, 1);
+}
+
+void ngli_memstats_remove(struct memstats_entry *entry)
+{
+    if (!entry->ctx_stats)
+        return;
+
+    stats_add(entry->ctx_stats, entry->category, -entry->size, -1);
+    stats_add(entry->node_stats, entry->category, -entry->size, -1);
+    memset(entry, 0, sizeof(*entry));
+}
+
+void ngli_memstats_copy(struct ngl_memory_stats *dst, const struct ngl_memory_stats *src)
+{
+    for (int i = 0; i < NGL_NB_MEMORY; i++) {
+        dst->sizes[i] = __atomic_load_n(&src->sizes[i], __ATOMIC_RELAXED);
+        dst->counts[i] = __atomic_load_n(&src->counts[i], __ATOMIC_RELAXED);
+    }
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2018 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef MEMSTATS_H
+#define MEMSTATS_H
+
+#include <stdint.h>
+
+#include "nodegl.h"
+
+/*
+ * Accounting of an allocated object into the memory statistics of its
+ * context and of the node it has been allocated for, if any.
+ */
+struct memstats_entry {
+    struct ngl_memory_stats *ctx_stats;
+    struct ngl_memory_stats *node_stats;
+    int category;
+    int64_t size;
+};
+
+/*
+ * Account an object of the given category (NGL_MEMORY_*) and size into the
+ * context statistics, and into the statistics of the current owner of the
+ * calling thread. The statistics can be updated from any thread.
+ */
+void ngli_memstats_add(struct memstats_entry *entry, struct ngl_memory_stats *ctx_stats,
+                       int category, int64_t size);
+void ngli_memstats_remove(struct memstats_entry *entry);
+
+/*
+ * Set the statistics into which the objects allocated by the calling thread
+ * are accounted in addition to the context ones (typically the ones of the
+ * node being initialized or updated) and return the previous ones.
+ */
+struct ngl_memory_stats *ngli_memstats_set_owner(struct ngl_memory_stats *owner);
+
+void ngli_memstats_copy(struct ngl_memory_stats *dst, const struct ngl_memory_stats *src);
+
+#endif /* MEMSTATS_H */
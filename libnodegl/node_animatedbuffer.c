@@ -120,6 +120,9 @@ static int animatedbuffer_init(struct ngl_node *node)
         return -1;
     s->data_size = s->count * s->data_stride;
 
+    ngli_memstats_add(&s->data_memstats, &node->ctx->glcontext->memstats,
+                      NGL_MEMORY_BUFFERS_CPU, s->data_size);
+
     return 0;
 }
 
@@ -127,6 +130,7 @@ static void animatedbuffer_uninit(struct ngl_node *node)
 {
     struct buffer_priv *s = node->priv_data;
 
+    ngli_memstats_remove(&s->data_memstats);
     ngli_free(s->data);
     s->data = NULL;
 }
@@ -134,6 +138,7 @@ static void animatedbuffer_uninit(struct ngl_node *node)
 const struct node_class ngli_animatedbufferfloat_class = {
     .id        = NGL_NODE_ANIMATEDBUFFERFLOAT,
     .name      = "AnimatedBufferFloat",
+    .flags     = NODE_FLAG_TIME_DEPENDENT | NODE_FLAG_PARALLEL_UPDATE,
     .init      = animatedbuffer_init,
     .update    = animatedbuffer_update,
     .uninit    = animatedbuffer_uninit,
@@ -145,6 +150,7 @@ const struct node_class ngli_animatedbufferfloat_class = {
 const struct node_class ngli_animatedbuffervec2_class = {
     .id        = NGL_NODE_ANIMATEDBUFFERVEC2,
     .name      = "AnimatedBufferVec2",
+    .flags     = NODE_FLAG_TIME_DEPENDENT | NODE_FLAG_PARALLEL_UPDATE,
     .init      = animatedbuffer_init,
     .update    = animatedbuffer_update,
     .uninit    = animatedbuffer_uninit,
@@ -156,6 +162,7 @@ const struct node_class ngli_animatedbuffervec2_class = {
 const struct node_class ngli_animatedbuffervec3_class = {
     .id        = NGL_NODE_ANIMATEDBUFFERVEC3,
     .name      = "AnimatedBufferVec3",
+    .flags     = NODE_FLAG_TIME_DEPENDENT | NODE_FLAG_PARALLEL_UPDATE,
     .init      = animatedbuffer_init,
     .update    = animatedbuffer_update,
     .uninit    = animatedbuffer_uninit,
@@ -167,6 +174,7 @@ const struct node_class ngli_animatedbuffervec3_class = {
 const struct node_class ngli_animatedbuffervec4_class = {
     .id        = NGL_NODE_ANIMATEDBUFFERVEC4,
     .name      = "AnimatedBufferVec4",
+    .flags     = NODE_FLAG_TIME_DEPENDENT | NODE_FLAG_PARALLEL_UPDATE,
     .init      = animatedbuffer_init,
     .update    = animatedbuffer_update,
     .uninit    = animatedbuffer_uninit,
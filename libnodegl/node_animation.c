@@ -197,6 +197,7 @@ static int animatedvec_update(struct ngl_node *node, double t)
 const struct node_class ngli_animatedfloat_class = {
     .id        = NGL_NODE_ANIMATEDFLOAT,
     .name      = "AnimatedFloat",
+    .flags     = NODE_FLAG_TIME_DEPENDENT | NODE_FLAG_PARALLEL_UPDATE,
     .init      = animation_init,
     .update    = animatedfloat_update,
     .priv_size = sizeof(struct animation_priv),
@@ -207,6 +208,7 @@ const struct node_class ngli_animatedfloat_class = {
 const struct node_class ngli_animatedvec2_class = {
     .id        = NGL_NODE_ANIMATEDVEC2,
     .name      = "AnimatedVec2",
+    .flags     = NODE_FLAG_TIME_DEPENDENT | NODE_FLAG_PARALLEL_UPDATE,
     .init      = animation_init,
     .update    = animatedvec_update,
     .priv_size = sizeof(struct animation_priv),
@@ -217,6 +219,7 @@ const struct node_class ngli_animatedvec2_class = {
 const struct node_class ngli_animatedvec3_class = {
     .id        = NGL_NODE_ANIMATEDVEC3,
     .name      = "AnimatedVec3",
+    .flags     = NODE_FLAG_TIME_DEPENDENT | NODE_FLAG_PARALLEL_UPDATE,
     .init      = animation_init,
     .update    = animatedvec_update,
     .priv_size = sizeof(struct animation_priv),
@@ -227,6 +230,7 @@ const struct node_class ngli_animatedvec3_class = {
 const struct node_class ngli_animatedvec4_class = {
     .id        = NGL_NODE_ANIMATEDVEC4,
     .name      = "AnimatedVec4",
+    .flags     = NODE_FLAG_TIME_DEPENDENT | NODE_FLAG_PARALLEL_UPDATE,
     .init      = animation_init,
     .update    = animatedvec_update,
     .priv_size = sizeof(struct animation_priv),
@@ -237,6 +241,7 @@ const struct node_class ngli_animatedvec4_class = {
 const struct node_class ngli_animatedquat_class = {
     .id        = NGL_NODE_ANIMATEDQUAT,
     .name      = "AnimatedQuat",
+    .flags     = NODE_FLAG_TIME_DEPENDENT | NODE_FLAG_PARALLEL_UPDATE,
     .init      = animation_init,
     .update    = animatedvec_update,
     .priv_size = sizeof(struct animation_priv),
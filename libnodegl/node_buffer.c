@@ -80,7 +80,10 @@ int ngli_node_buffer_ref(struct ngl_node *node)
     struct buffer_priv *s = node->priv_data;
 
     if (s->buffer_refcount++ == 0) {
+        /* The buffer is accounted to its node, not to the one referencing it */
+        struct ngl_memory_stats *prev_owner = ngli_memstats_set_owner(&node->memstats);
         int ret = ngli_buffer_allocate(&s->buffer, gl, s->data_size, s->usage);
+        ngli_memstats_set_owner(prev_owner);
         if (ret < 0)
             return ret;
 
@@ -256,6 +259,9 @@ static int buffer_init(struct ngl_node *node)
     if (ret < 0)
         return ret;
 
+    ngli_memstats_add(&s->data_memstats, &node->ctx->glcontext->memstats,
+                      NGL_MEMORY_BUFFERS_CPU, s->data_size);
+
     return 0;
 }
 
@@ -263,6 +269,8 @@ static void buffer_uninit(struct ngl_node *node)
 {
     struct buffer_priv *s = node->priv_data;
 
+    ngli_memstats_remove(&s->data_memstats);
+
     if (s->filename) {
         ngli_free(s->data);
         s->data = NULL;
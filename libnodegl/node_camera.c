@@ -224,17 +224,23 @@ static int camera_update(struct ngl_node *node, double t)
     return ngli_node_update(child, t);
 }
 
-static void camera_draw(struct ngl_node *node)
+int ngli_camera_draw_begin(struct ngl_node *node)
 {
     struct ngl_ctx *ctx = node->ctx;
-    struct glcontext *gl = ctx->glcontext;
     struct camera_priv *s = node->priv_data;
 
     if (!ngli_darray_push(&ctx->modelview_matrix_stack, s->modelview_matrix) ||
         !ngli_darray_push(&ctx->projection_matrix_stack, s->projection_matrix))
-        return;
+        return -1;
 
-    ngli_node_draw(s->child);
+    return 0;
+}
+
+void ngli_camera_draw_end(struct ngl_node *node)
+{
+    struct ngl_ctx *ctx = node->ctx;
+    struct glcontext *gl = ctx->glcontext;
+    struct camera_priv *s = node->priv_data;
 
     ngli_darray_pop(&ctx->modelview_matrix_stack);
     ngli_darray_pop(&ctx->projection_matrix_stack);
@@ -271,6 +277,16 @@ static void camera_draw(struct ngl_node *node)
     }
 }
 
+static void camera_draw(struct ngl_node *node)
+{
+    struct camera_priv *s = node->priv_data;
+
+    if (ngli_camera_draw_begin(node) < 0)
+        return;
+    ngli_node_draw(s->child);
+    ngli_camera_draw_end(node);
+}
+
 static void camera_uninit(struct ngl_node *node)
 {
     struct camera_priv *s = node->priv_data;
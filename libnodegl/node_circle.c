@@ -104,6 +104,8 @@ static int circle_init(struct ngl_node *node)
 
     s->topology = GL_TRIANGLE_FAN;
 
+    ngli_node_geometry_compute_bbox(s);
+
     ret = 0;
 
 end:
@@ -75,6 +75,8 @@ static const struct node_param compute_params[] = {
                    .desc=NGLI_DOCSTRING("input and output textures made accessible to the compute `program`")},
     {"uniforms",   PARAM_TYPE_NODEDICT, OFFSET(pipeline.uniforms),   .node_types=UNIFORMS_TYPES_LIST,
                    .desc=NGLI_DOCSTRING("uniforms made accessible to the compute `program`")},
+    {"uniforms_block", PARAM_TYPE_STR,  OFFSET(pipeline.uniforms_block),
+                       .desc=NGLI_DOCSTRING("name of a `std140` uniform block of the compute `program` in which the matching `uniforms` are packed and uploaded as a single buffer")},
     {"buffers",    PARAM_TYPE_NODEDICT, OFFSET(pipeline.buffers),    .node_types=BUFFERS_TYPES_LIST,
                    .desc=NGLI_DOCSTRING("input and output buffers made accessible to the compute `program`")},
     {NULL}
@@ -125,7 +127,7 @@ static void compute_draw(struct ngl_node *node)
     struct compute_priv *s = node->priv_data;
 
     const struct program_priv *program = s->pipeline.program->priv_data;
-    ngli_glUseProgram(gl, program->program_id);
+    ngli_glUseProgram(gl, program->program->id);
 
     int ret = ngli_pipeline_upload_data(node);
     if (ret < 0) {
@@ -36,35 +36,15 @@ static const struct node_param computeprogram_params[] = {
     {NULL}
 };
 
-static GLuint load_shader(struct ngl_node *node, const char *compute_shader_data)
+static int computeprogram_pre_init(struct ngl_node *node)
 {
     struct ngl_ctx *ctx = node->ctx;
     struct glcontext *gl = ctx->glcontext;
+    struct program_priv *s = node->priv_data;
 
-    GLuint program = ngli_glCreateProgram(gl);
-    GLuint compute_shader = ngli_glCreateShader(gl, GL_COMPUTE_SHADER);
-
-    ngli_glShaderSource(gl, compute_shader, 1, &compute_shader_data, NULL);
-    ngli_glCompileShader(gl, compute_shader);
-    if (ngli_program_check_status(gl, compute_shader, GL_COMPILE_STATUS) < 0)
-        goto fail;
-
-    ngli_glAttachShader(gl, program, compute_shader);
-    ngli_glLinkProgram(gl, program);
-    if (ngli_program_check_status(gl, program, GL_LINK_STATUS) < 0)
-        goto fail;
-
-    ngli_glDeleteShader(gl, compute_shader);
-
-    return program;
-
-fail:
-    if (compute_shader)
-        ngli_glDeleteShader(gl, compute_shader);
-    if (program)
-        ngli_glDeleteProgram(gl, program);
-
-    return 0;
+    if (!(gl->features & NGLI_FEATURE_COMPUTE_SHADER_ALL))
+        return 0;
+    return ngli_program_build_start(ctx, NULL, NULL, s->compute);
 }
 
 static int computeprogram_init(struct ngl_node *node)
@@ -78,13 +58,8 @@ static int computeprogram_init(struct ngl_node *node)
         return -1;
     }
 
-    s->program_id = load_shader(node, s->compute);
-    if (!s->program_id)
-        return -1;
-
-    s->active_uniforms = ngli_program_probe_uniforms(node->label, gl, s->program_id);
-    s->active_buffer_blocks = ngli_program_probe_buffer_blocks(node->label, gl, s->program_id);
-    if (!s->active_uniforms || !s->active_buffer_blocks)
+    s->program = ngli_program_get(ctx, node->label, NULL, NULL, s->compute);
+    if (!s->program)
         return -1;
 
     return 0;
@@ -92,18 +67,16 @@ static int computeprogram_init(struct ngl_node *node)
 
 static void computeprogram_uninit(struct ngl_node *node)
 {
-    struct ngl_ctx *ctx = node->ctx;
-    struct glcontext *gl = ctx->glcontext;
     struct program_priv *s = node->priv_data;
 
-    ngli_hmap_freep(&s->active_uniforms);
-    ngli_hmap_freep(&s->active_buffer_blocks);
-    ngli_glDeleteProgram(gl, s->program_id);
+    ngli_program_unrefp(node->ctx, &s->program);
 }
 
 const struct node_class ngli_computeprogram_class = {
     .id        = NGL_NODE_COMPUTEPROGRAM,
     .name      = "ComputeProgram",
+    .flags     = NODE_FLAG_REUSABLE,
+    .pre_init  = computeprogram_pre_init,
     .init      = computeprogram_init,
     .uninit    = computeprogram_uninit,
     .priv_size = sizeof(struct program_priv),
@@ -26,6 +26,7 @@
 #include "log.h"
 #include "nodegl.h"
 #include "nodes.h"
+#include "utils.h"
 
 struct ngl_node *ngli_node_geometry_generate_buffer(struct ngl_ctx *ctx, int type, int count, int size, void *data)
 {
@@ -47,6 +48,23 @@ fail:
     return NULL;
 }
 
+void ngli_node_geometry_compute_bbox(struct geometry_priv *s)
+{
+    const struct buffer_priv *vertices = s->vertices_buffer->priv_data;
+
+    s->has_bbox = !vertices->dynamic && vertices->count > 0;
+    if (!s->has_bbox)
+        return;
+
+    for (int i = 0; i < vertices->count; i++) {
+        const float *v = (const float *)(vertices->data + i * vertices->data_stride);
+        for (int j = 0; j < 3; j++) {
+            s->bbox[0][j] = i ? NGLI_MIN(s->bbox[0][j], v[j]) : v[j];
+            s->bbox[1][j] = i ? NGLI_MAX(s->bbox[1][j], v[j]) : v[j];
+        }
+    }
+}
+
 static const struct param_choices topology_choices = {
     .name = "topology",
     .consts = {
@@ -121,6 +139,8 @@ static int geometry_init(struct ngl_node *node)
         }
     }
 
+    ngli_node_geometry_compute_bbox(s);
+
     return 0;
 }
 
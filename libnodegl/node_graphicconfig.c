@@ -187,7 +187,7 @@ static int graphicconfig_update(struct ngl_node *node, double t)
     }                                \
 } while (0)                          \
 
-static void honor_config(struct ngl_node *node, int restore)
+void ngli_graphicconfig_honor(struct ngl_node *node, int restore)
 {
     struct ngl_ctx *ctx = node->ctx;
     struct glcontext *gl = ctx->glcontext;
@@ -242,9 +242,9 @@ static void graphicconfig_draw(struct ngl_node *node)
     struct graphicconfig_priv *s = node->priv_data;
     struct ngl_node *child = s->child;
 
-    honor_config(node, 0);
+    ngli_graphicconfig_honor(node, 0);
     ngli_node_draw(child);
-    honor_config(node, 1);
+    ngli_graphicconfig_honor(node, 1);
 }
 
 const struct node_class ngli_graphicconfig_class = {
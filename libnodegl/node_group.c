@@ -19,24 +19,619 @@
  * under the License.
  */
 
+#include <limits.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include "buffer.h"
+#include "glcontext.h"
+#include "hmap.h"
+#include "instancing.h"
+#include "log.h"
+#include "math_utils.h"
+#include "memory.h"
 #include "nodegl.h"
 #include "nodes.h"
-
-struct group_priv {
-    struct ngl_node **children;
-    int nb_children;
-};
+#include "utils.h"
 
 #define OFFSET(x) offsetof(struct group_priv, x)
 static const struct node_param group_params[] = {
     {"children", PARAM_TYPE_NODELIST, OFFSET(children),
                  .desc=NGLI_DOCSTRING("a set of scenes")},
+    {"sort",     PARAM_TYPE_BOOL, OFFSET(sort),
+                 .desc=NGLI_DOCSTRING("draw the `children` grouped by GraphicConfig, program and textures "
+                                      "to reduce the GL state changes, instead of in their declaration order; "
+                                      "must only be enabled if the children can be drawn in any order")},
+    {"instancing", PARAM_TYPE_BOOL, OFFSET(instancing),
+                   .desc=NGLI_DOCSTRING("draw the consecutive children only differing by their transforms and "
+                                        "their float or vector uniforms with a single instanced draw call; "
+                                        "combined with `sort`, such children are made consecutive; "
+                                        "Renders with `frustum_culling` are never merged since an "
+                                        "instanced draw cannot cull its children individually")},
     {NULL}
 };
 
+#define MAX_KEY_TEXTURES 8
+
+/* State required by the draw of a child, the lower fields changing the most */
+struct draw_key {
+    const struct ngl_node *graphicconfig;
+    const struct program *program;
+    const struct ngl_node *textures[MAX_KEY_TEXTURES];
+    int index;
+};
+
+static int cmp_pointers(const void *a, const void *b)
+{
+    const uintptr_t pa = (uintptr_t)a;
+    const uintptr_t pb = (uintptr_t)b;
+    return (pa > pb) - (pa < pb);
+}
+
+static int cmp_textures(const void *a, const void *b)
+{
+    return cmp_pointers(*(const struct ngl_node * const *)a, *(const struct ngl_node * const *)b);
+}
+
+static int cmp_draw_key(const void *a, const void *b)
+{
+    const struct draw_key *ka = a;
+    const struct draw_key *kb = b;
+
+    int ret;
+    if ((ret = cmp_pointers(ka->graphicconfig, kb->graphicconfig)) ||
+        (ret = cmp_pointers(ka->program, kb->program)))
+        return ret;
+    for (int i = 0; i < MAX_KEY_TEXTURES; i++)
+        if ((ret = cmp_pointers(ka->textures[i], kb->textures[i])))
+            return ret;
+
+    /* Keep the declaration order between children requiring the same state */
+    return ka->index - kb->index;
+}
+
+/*
+ * The key of a child is the state of the Render reached by following the
+ * transforms and graphic configurations; any other child gets an empty key.
+ */
+static void get_draw_key(struct draw_key *key, const struct ngl_node *node, int index)
+{
+    memset(key, 0, sizeof(*key));
+    key->index = index;
+
+    for (;;) {
+        switch (node->class->id) {
+            case NGL_NODE_ROTATE:
+            case NGL_NODE_TRANSLATE:
+            case NGL_NODE_SCALE:
+            case NGL_NODE_TRANSFORM: {
+                const struct transform_priv *s = node->priv_data;
+                node = s->child;
+                break;
+            }
+            case NGL_NODE_GRAPHICCONFIG: {
+                const struct graphicconfig_priv *s = node->priv_data;
+                key->graphicconfig = node;
+                node = s->child;
+                break;
+            }
+            case NGL_NODE_RENDER: {
+                const struct render_priv *s = node->priv_data;
+                const struct program_priv *program = s->pipeline.program->priv_data;
+                key->program = program->program;
+
+                int nb_textures = 0;
+                const struct hmap_entry *entry = NULL;
+                while (s->pipeline.textures && nb_textures < MAX_KEY_TEXTURES &&
+                       (entry = ngli_hmap_next(s->pipeline.textures, entry)))
+                    key->textures[nb_textures++] = entry->data;
+                qsort(key->textures, nb_textures, sizeof(*key->textures), cmp_textures);
+                return;
+            }
+            default:
+                return;
+        }
+    }
+}
+
+static int count_state_changes(const struct draw_key *keys, int nb_keys)
+{
+    int nb_changes = 0;
+    for (int i = 1; i < nb_keys; i++) {
+        const struct draw_key *prev = &keys[i - 1];
+        const struct draw_key *cur = &keys[i];
+        nb_changes += prev->graphicconfig != cur->graphicconfig;
+        nb_changes += prev->program != cur->program;
+        for (int j = 0; j < MAX_KEY_TEXTURES; j++)
+            nb_changes += prev->textures[j] != cur->textures[j];
+    }
+    return nb_changes;
+}
+
+#define MIN_BATCH_INSTANCES 2
+
+/* Buffer of per instance values, with the range changed since its last upload */
+struct instance_buffer {
+    struct ngl_node *node;
+    int dirty_start;
+    int dirty_end;
+};
+
+/* Uniform whose value changes between the instances of a batch */
+struct instance_var {
+    char name[MAX_ID_LEN];
+    int nb_comp;
+    struct instance_buffer buffer;
+};
+
+/* Consecutive children drawn at once by an instanced Render */
+struct instancing_batch {
+    int start;                              /* index of the first child in draw_children */
+    int nb_instances;
+    struct ngl_node *render;
+    struct instance_buffer modelview[4];    /* per instance modelview matrix columns */
+    struct instance_buffer normal[3];       /* per instance normal matrix columns */
+    struct instance_var vars[NGLI_INSTANCING_MAX_VARS];
+    int nb_vars;
+};
+
+static const struct {
+    int class_id;
+    const char *type;
+    int nb_comp;
+} instance_uniform_types[] = {
+    {NGL_NODE_UNIFORMFLOAT, "float", 1},
+    {NGL_NODE_UNIFORMVEC2,  "vec2",  2},
+    {NGL_NODE_UNIFORMVEC3,  "vec3",  3},
+    {NGL_NODE_UNIFORMVEC4,  "vec4",  4},
+};
+
+static int get_instance_uniform_type(const struct ngl_node *node)
+{
+    for (int i = 0; i < NGLI_ARRAY_NB(instance_uniform_types); i++)
+        if (instance_uniform_types[i].class_id == node->class->id)
+            return i;
+    return -1;
+}
+
+/* Render reached by following the transforms of a child, if any */
+static const struct ngl_node *get_instancing_render(const struct ngl_node *node)
+{
+    for (;;) {
+        switch (node->class->id) {
+            case NGL_NODE_ROTATE:
+            case NGL_NODE_TRANSLATE:
+            case NGL_NODE_SCALE:
+            case NGL_NODE_TRANSFORM: {
+                const struct transform_priv *s = node->priv_data;
+                node = s->child;
+                break;
+            }
+            case NGL_NODE_RENDER: {
+                const struct render_priv *s = node->priv_data;
+                /* An instanced draw cannot cull its children individually */
+                if (s->nb_instances || s->instance_attributes || s->pipeline.uniforms_block ||
+                    s->frustum_culling)
+                    return NULL;
+                return node;
+            }
+            default:
+                return NULL;
+        }
+    }
+}
+
+static int nodedicts_equal(struct hmap *a, struct hmap *b)
+{
+    const int nb_a = a ? ngli_hmap_count(a) : 0;
+    const int nb_b = b ? ngli_hmap_count(b) : 0;
+    if (nb_a != nb_b)
+        return 0;
+
+    const struct hmap_entry *entry = NULL;
+    while (nb_a && (entry = ngli_hmap_next(a, entry)))
+        if (ngli_hmap_get(b, entry->key) != entry->data)
+            return 0;
+    return 1;
+}
+
+/*
+ * Whether two Render nodes only differ by their float and vector uniforms,
+ * in which case they can be drawn as instances of the same draw call.
+ */
+static int can_instance(const struct ngl_node *a, const struct ngl_node *b)
+{
+    const struct render_priv *ra = a->priv_data;
+    const struct render_priv *rb = b->priv_data;
+    const struct program_priv *pa = ra->pipeline.program->priv_data;
+    const struct program_priv *pb = rb->pipeline.program->priv_data;
+
+    if (ra->geometry != rb->geometry || pa->program != pb->program ||
+        !nodedicts_equal(ra->pipeline.textures, rb->pipeline.textures) ||
+        !nodedicts_equal(ra->pipeline.buffers, rb->pipeline.buffers) ||
+        !nodedicts_equal(ra->attributes, rb->attributes))
+        return 0;
+
+    struct hmap *ua = ra->pipeline.uniforms;
+    struct hmap *ub = rb->pipeline.uniforms;
+    if ((ua ? ngli_hmap_count(ua) : 0) != (ub ? ngli_hmap_count(ub) : 0))
+        return 0;
+
+    const struct hmap_entry *entry = NULL;
+    while (ua && (entry = ngli_hmap_next(ua, entry))) {
+        const struct ngl_node *uniform_a = entry->data;
+        const struct ngl_node *uniform_b = ngli_hmap_get(ub, entry->key);
+        if (!uniform_b)
+            return 0;
+        if (uniform_a != uniform_b &&
+            (uniform_a->class != uniform_b->class || get_instance_uniform_type(uniform_a) < 0))
+            return 0;
+    }
+    return 1;
+}
+
+static struct ngl_node *get_child_render(const struct group_priv *s, int index)
+{
+    return (struct ngl_node *)get_instancing_render(s->draw_children[index]);
+}
+
+static int set_instance_buffer(struct ngl_node *render, struct instance_buffer *instance_buffer,
+                               int nb_comp, int count, const char *name)
+{
+    static const int buffer_types[] = {
+        NGL_NODE_BUFFERFLOAT,
+        NGL_NODE_BUFFERVEC2,
+        NGL_NODE_BUFFERVEC3,
+        NGL_NODE_BUFFERVEC4,
+    };
+    struct ngl_node *buffer = ngl_node_create(buffer_types[nb_comp - 1], count);
+    if (!buffer)
+        return -1;
+    instance_buffer->node = buffer;
+    instance_buffer->dirty_start = INT_MAX;
+    instance_buffer->dirty_end = 0;
+
+    int ret = ngl_node_param_set(buffer, "usage", "dynamic_draw");
+    if (ret < 0)
+        return ret;
+    return ngl_node_param_set(render, "instance_attributes", name, buffer);
+}
+
+static void reset_batch(struct instancing_batch *batch)
+{
+    if (batch->render) {
+        ngli_node_detach_ctx(batch->render);
+        ngl_node_unrefp(&batch->render);
+    }
+    for (int i = 0; i < NGLI_ARRAY_NB(batch->modelview); i++)
+        ngl_node_unrefp(&batch->modelview[i].node);
+    for (int i = 0; i < NGLI_ARRAY_NB(batch->normal); i++)
+        ngl_node_unrefp(&batch->normal[i].node);
+    for (int i = 0; i < batch->nb_vars; i++)
+        ngl_node_unrefp(&batch->vars[i].buffer.node);
+}
+
+/*
+ * Create the instanced Render drawing the children [start, start+count) of
+ * the group. Return 1 if they cannot be drawn that way.
+ */
+static int init_batch(struct ngl_node *node, struct instancing_batch *batch, int start, int count)
+{
+    struct ngl_ctx *ctx = node->ctx;
+    const struct group_priv *s = node->priv_data;
+    const struct ngl_node *first = get_child_render(s, start);
+    const struct render_priv *render = first->priv_data;
+    const struct program_priv *program = render->pipeline.program->priv_data;
+
+    memset(batch, 0, sizeof(*batch));
+    batch->start = start;
+    batch->nb_instances = count;
+
+    /* The uniforms with different nodes among the children become per instance */
+    struct instancing_var vars[NGLI_INSTANCING_MAX_VARS];
+    const struct hmap_entry *entry = NULL;
+    while (render->pipeline.uniforms && (entry = ngli_hmap_next(render->pipeline.uniforms, entry))) {
+        int i;
+        for (i = start + 1; i < start + count; i++) {
+            const struct render_priv *r = get_child_render(s, i)->priv_data;
+            if (ngli_hmap_get(r->pipeline.uniforms, entry->key) != entry->data)
+                break;
+        }
+        if (i == start + count)
+            continue;
+
+        if (batch->nb_vars == NGLI_INSTANCING_MAX_VARS) {
+            LOG(DEBUG, "%s: too many per instance uniforms", node->label);
+            return 1;
+        }
+        const int type = get_instance_uniform_type(entry->data);
+        struct instance_var *var = &batch->vars[batch->nb_vars];
+        snprintf(var->name, sizeof(var->name), "%s", entry->key);
+        var->nb_comp = instance_uniform_types[type].nb_comp;
+        vars[batch->nb_vars++] = (struct instancing_var){
+            .name = var->name,
+            .type = instance_uniform_types[type].type,
+        };
+    }
+
+    struct instancing_shaders shaders;
+    int ret = ngli_instancing_rewrite(&shaders, program->vertex, program->fragment,
+                                      vars, batch->nb_vars);
+    if (ret) {
+        if (ret > 0)
+            LOG(DEBUG, "%s: shaders of %s cannot be instanced", node->label, render->pipeline.program->label);
+        return ret;
+    }
+
+    struct ngl_node *instanced_program = ngl_node_create(NGL_NODE_PROGRAM);
+    if (!instanced_program) {
+        ngli_instancing_reset(&shaders);
+        return -1;
+    }
+    ret = ngl_node_param_set(instanced_program, "vertex", shaders.vertex);
+    if (ret >= 0)
+        ret = ngl_node_param_set(instanced_program, "fragment", shaders.fragment);
+    if (ret >= 0) {
+        batch->render = ngl_node_create(NGL_NODE_RENDER, render->geometry);
+        if (batch->render)
+            ret = ngl_node_param_set(batch->render, "program", instanced_program);
+        else
+            ret = -1;
+    }
+    ngl_node_unrefp(&instanced_program);
+    if (ret < 0)
+        goto fail;
+
+    struct hmap *dicts[] = {render->pipeline.textures, render->pipeline.buffers, render->attributes};
+    static const char *dict_names[] = {"textures", "buffers", "attributes"};
+    for (int i = 0; i < NGLI_ARRAY_NB(dicts); i++) {
+        entry = NULL;
+        while (dicts[i] && (entry = ngli_hmap_next(dicts[i], entry)))
+            if ((ret = ngl_node_param_set(batch->render, dict_names[i], entry->key, entry->data)) < 0)
+                goto fail;
+    }
+
+    entry = NULL;
+    while (render->pipeline.uniforms && (entry = ngli_hmap_next(render->pipeline.uniforms, entry))) {
+        int shared = 1;
+        for (int i = 0; i < batch->nb_vars; i++)
+            shared &= strcmp(batch->vars[i].name, entry->key) != 0;
+        if (shared && (ret = ngl_node_param_set(batch->render, "uniforms", entry->key, entry->data)) < 0)
+            goto fail;
+    }
+
+    char name[MAX_ID_LEN];
+    for (int i = 0; shaders.has_modelview && i < NGLI_ARRAY_NB(batch->modelview); i++) {
+        snprintf(name, sizeof(name), NGLI_INSTANCING_MODELVIEW_FMT, i);
+        if ((ret = set_instance_buffer(batch->render, &batch->modelview[i], 4, count, name)) < 0)
+            goto fail;
+    }
+    for (int i = 0; shaders.has_normal && i < NGLI_ARRAY_NB(batch->normal); i++) {
+        snprintf(name, sizeof(name), NGLI_INSTANCING_NORMAL_FMT, i);
+        if ((ret = set_instance_buffer(batch->render, &batch->normal[i], 3, count, name)) < 0)
+            goto fail;
+    }
+    for (int i = 0; i < batch->nb_vars; i++) {
+        struct instance_var *var = &batch->vars[i];
+        if (!vars[i].used)
+            continue;
+        snprintf(name, sizeof(name), NGLI_INSTANCING_VAR_FMT, var->name);
+        if ((ret = set_instance_buffer(batch->render, &var->buffer, var->nb_comp, count, name)) < 0)
+            goto fail;
+    }
+
+    if ((ret = ngl_node_param_set(batch->render, "nb_instances", count)) < 0)
+        goto fail;
+
+    ngli_instancing_reset(&shaders);
+
+    ret = ngli_node_attach_ctx(batch->render, ctx);
+    if (ret < 0) {
+        LOG(WARNING, "%s: could not create the instanced draw of %d children, "
+            "drawing them separately", node->label, count);
+        reset_batch(batch);
+        return 1;
+    }
+    return 0;
+
+fail:
+    ngli_instancing_reset(&shaders);
+    reset_batch(batch);
+    return ret;
+}
+
+static int init_batches(struct ngl_node *node)
+{
+    struct glcontext *gl = node->ctx->glcontext;
+    struct group_priv *s = node->priv_data;
+
+    ngli_darray_init(&s->batches, sizeof(struct instancing_batch), 0);
+
+    if (!(gl->features & NGLI_FEATURE_DRAW_INSTANCED) ||
+        !(gl->features & NGLI_FEATURE_INSTANCED_ARRAY)) {
+        LOG(WARNING, "%s: context does not support instanced draws, "
+            "children will be drawn separately", node->label);
+        return 0;
+    }
+
+    int i = 0;
+    while (i < s->nb_children) {
+        const struct ngl_node *first = get_child_render(s, i);
+        int count = 1;
+        while (first && i + count < s->nb_children) {
+            const struct ngl_node *render = get_child_render(s, i + count);
+            if (!render || !can_instance(first, render))
+                break;
+            count++;
+        }
+
+        if (count >= MIN_BATCH_INSTANCES) {
+            struct instancing_batch batch;
+            int ret = init_batch(node, &batch, i, count);
+            if (ret < 0)
+                return ret;
+            if (ret == 0 && !ngli_darray_push(&s->batches, &batch)) {
+                reset_batch(&batch);
+                return -1;
+            }
+        }
+        i += count;
+    }
+
+    const int nb_batches = ngli_darray_count(&s->batches);
+    if (nb_batches) {
+        const struct instancing_batch *batches = ngli_darray_data(&s->batches);
+        int nb_instances = 0;
+        for (int i = 0; i < nb_batches; i++)
+            nb_instances += batches[i].nb_instances;
+        LOG(DEBUG, "%s: %d children drawn with %d instanced draws",
+            node->label, nb_instances, nb_batches);
+    }
+
+    return 0;
+}
+
+/*
+ * Write the value of an instance into the CPU copy of the buffer, tracking
+ * the range which changed, as for the uniforms blocks of the pipelines.
+ */
+static void write_instance_data(struct instance_buffer *s, int index, const float *data)
+{
+    struct buffer_priv *buffer = s->node->priv_data;
+    const int offset = index * buffer->data_stride;
+    const int size = buffer->data_comp * sizeof(*data);
+    uint8_t *dst = buffer->data + offset;
+    if (!memcmp(dst, data, size))
+        return;
+    memcpy(dst, data, size);
+    s->dirty_start = NGLI_MIN(s->dirty_start, offset);
+    s->dirty_end   = NGLI_MAX(s->dirty_end, offset + size);
+}
+
+static void upload_instance_data(struct instance_buffer *s)
+{
+    if (!s->node || s->dirty_start >= s->dirty_end)
+        return;
+
+    struct buffer_priv *buffer = s->node->priv_data;
+    struct glcontext *gl = buffer->buffer.gl;
+    ngli_glBindBuffer(gl, GL_ARRAY_BUFFER, buffer->buffer.id);
+    ngli_glBufferSubData(gl, GL_ARRAY_BUFFER, s->dirty_start, s->dirty_end - s->dirty_start,
+                         buffer->data + s->dirty_start);
+    s->dirty_start = INT_MAX;
+    s->dirty_end = 0;
+}
+
+static void draw_batch(struct ngl_node *node, struct instancing_batch *batch)
+{
+    struct ngl_ctx *ctx = node->ctx;
+    const struct group_priv *s = node->priv_data;
+    const float *modelview_matrix = ngli_darray_tail(&ctx->modelview_matrix_stack);
+
+    for (int i = 0; i < batch->nb_instances; i++) {
+        const struct ngl_node *child = s->draw_children[batch->start + i];
+
+        NGLI_ALIGNED_MAT(matrix);
+        memcpy(matrix, modelview_matrix, sizeof(matrix));
+        while (child->class->id != NGL_NODE_RENDER) {
+            const struct transform_priv *trf = child->priv_data;
+            NGLI_ALIGNED_MAT(tmp);
+            ngli_mat4_mul(tmp, matrix, trf->matrix);
+            memcpy(matrix, tmp, sizeof(matrix));
+            child = trf->child;
+        }
+
+        for (int j = 0; batch->modelview[0].node && j < 4; j++)
+            write_instance_data(&batch->modelview[j], i, matrix + 4 * j);
+
+        if (batch->normal[0].node) {
+            float normal_matrix[3*3];
+            ngli_mat3_from_mat4(normal_matrix, matrix);
+            ngli_mat3_inverse(normal_matrix, normal_matrix);
+            ngli_mat3_transpose(normal_matrix, normal_matrix);
+            for (int j = 0; j < 3; j++)
+                write_instance_data(&batch->normal[j], i, normal_matrix + 3 * j);
+        }
+
+        const struct render_priv *render = child->priv_data;
+        for (int j = 0; j < batch->nb_vars; j++) {
+            struct instance_var *var = &batch->vars[j];
+            if (!var->buffer.node)
+                continue;
+            const struct ngl_node *uniform = ngli_hmap_get(render->pipeline.uniforms, var->name);
+            const struct uniform_priv *u = uniform->priv_data;
+            const float scalar = u->scalar;
+            write_instance_data(&var->buffer, i, var->nb_comp == 1 ? &scalar : u->vector);
+        }
+    }
+
+    for (int j = 0; j < NGLI_ARRAY_NB(batch->modelview); j++)
+        upload_instance_data(&batch->modelview[j]);
+    for (int j = 0; j < NGLI_ARRAY_NB(batch->normal); j++)
+        upload_instance_data(&batch->normal[j]);
+    for (int j = 0; j < batch->nb_vars; j++)
+        upload_instance_data(&batch->vars[j].buffer);
+
+    ngli_node_draw(batch->render);
+}
+
+static int sort_children(struct ngl_node *node)
+{
+    struct ngl_ctx *ctx = node->ctx;
+    struct group_priv *s = node->priv_data;
+
+    struct draw_key *keys = ngli_calloc(s->nb_children, sizeof(*keys));
+    if (!keys)
+        return -1;
+
+    s->draw_children = ngli_calloc(s->nb_children, sizeof(*s->draw_children));
+    if (!s->draw_children) {
+        ngli_free(keys);
+        return -1;
+    }
+
+    for (int i = 0; i < s->nb_children; i++)
+        get_draw_key(&keys[i], s->children[i], i);
+    s->state_changes[0] = count_state_changes(keys, s->nb_children);
+
+    qsort(keys, s->nb_children, sizeof(*keys), cmp_draw_key);
+    for (int i = 0; i < s->nb_children; i++)
+        s->draw_children[i] = s->children[keys[i].index];
+    s->state_changes[1] = count_state_changes(keys, s->nb_children);
+
+    ngli_free(keys);
+
+    LOG(DEBUG, "%s children sorted: %d state changes instead of %d",
+        node->label, s->state_changes[1], s->state_changes[0]);
+
+    ctx->sort_stats.nb_groups++;
+    ctx->sort_stats.state_changes_unsorted += s->state_changes[0];
+    ctx->sort_stats.state_changes_sorted   += s->state_changes[1];
+    return 0;
+}
+
+static int group_init(struct ngl_node *node)
+{
+    struct group_priv *s = node->priv_data;
+
+    s->draw_children = s->children;
+    if (s->nb_children < 2)
+        return 0;
+
+    if (s->sort) {
+        int ret = sort_children(node);
+        if (ret < 0)
+            return ret;
+    }
+
+    if (s->instancing)
+        return init_batches(node);
+
+    return 0;
+}
+
 static int group_update(struct ngl_node *node, double t)
 {
     struct group_priv *s = node->priv_data;
@@ -48,23 +643,62 @@ static int group_update(struct ngl_node *node, double t)
             return ret;
     }
 
+    struct instancing_batch *batches = ngli_darray_data(&s->batches);
+    for (int i = 0; i < ngli_darray_count(&s->batches); i++) {
+        int ret = ngli_node_update(batches[i].render, t);
+        if (ret < 0)
+            return ret;
+    }
+
     return 0;
 }
 
 static void group_draw(struct ngl_node *node)
 {
     struct group_priv *s = node->priv_data;
-    for (int i = 0; i < s->nb_children; i++) {
-        struct ngl_node *child = s->children[i];
+    struct instancing_batch *batches = ngli_darray_data(&s->batches);
+    const int nb_batches = ngli_darray_count(&s->batches);
+    int batch_id = 0;
+
+    int i = 0;
+    while (i < s->nb_children) {
+        if (batch_id < nb_batches && batches[batch_id].start == i) {
+            struct instancing_batch *batch = &batches[batch_id++];
+            draw_batch(node, batch);
+            i += batch->nb_instances;
+            continue;
+        }
+        struct ngl_node *child = s->draw_children[i++];
         ngli_node_draw(child);
     }
 }
 
+static void group_uninit(struct ngl_node *node)
+{
+    struct ngl_ctx *ctx = node->ctx;
+    struct group_priv *s = node->priv_data;
+
+    if (s->draw_children && s->draw_children != s->children) {
+        ctx->sort_stats.nb_groups--;
+        ctx->sort_stats.state_changes_unsorted -= s->state_changes[0];
+        ctx->sort_stats.state_changes_sorted   -= s->state_changes[1];
+        ngli_free(s->draw_children);
+    }
+    s->draw_children = NULL;
+
+    struct instancing_batch *batches = ngli_darray_data(&s->batches);
+    for (int i = 0; i < ngli_darray_count(&s->batches); i++)
+        reset_batch(&batches[i]);
+    ngli_darray_reset(&s->batches);
+}
+
 const struct node_class ngli_group_class = {
     .id        = NGL_NODE_GROUP,
     .name      = "Group",
+    .init      = group_init,
     .update    = group_update,
     .draw      = group_draw,
+    .uninit    = group_uninit,
     .priv_size = sizeof(struct group_priv),
     .params    = group_params,
     .file      = __FILE__,
@@ -222,6 +222,7 @@ enum {
     DRAWCALL_COMPUTES,
     DRAWCALL_GRAPHICCONFIGS,
     DRAWCALL_RENDERS,
+    DRAWCALL_CULLED,
     DRAWCALL_RTTS,
     NB_DRAWCALL
 };
@@ -316,6 +317,7 @@ static const struct activity_spec {
 static const struct drawcall_spec {
     const char *label;
     const int *node_types;
+    int culled; /* count the draws skipped by frustum culling instead */
 } drawcall_specs[] = {
     [DRAWCALL_COMPUTES] = {
         .label="Computes",
@@ -329,6 +331,11 @@ static const struct drawcall_spec {
         .label="Renders",
         .node_types=(const int[]){NGL_NODE_RENDER, -1},
     },
+    [DRAWCALL_CULLED] = {
+        .label="Culled",
+        .node_types=(const int[]){NGL_NODE_RENDER, -1},
+        .culled=1,
+    },
     [DRAWCALL_RTTS] = {
         .label="RTTs",
         .node_types=(const int[]){NGL_NODE_RENDERTOTEXTURE, -1},
@@ -680,12 +687,14 @@ static void widget_activity_make_stats(struct ngl_node *node, struct widget *wid
 
 static void widget_drawcall_make_stats(struct ngl_node *node, struct widget *widget)
 {
+    const struct drawcall_spec *spec = widget->user_data;
     struct widget_drawcall *priv = widget->priv_data;
     struct darray *nodes_array = &priv->nodes;
     struct ngl_node **nodes = ngli_darray_data(nodes_array);
     priv->nb_draws = 0;
     for (int i = 0; i < ngli_darray_count(nodes_array); i++)
-        priv->nb_draws += nodes[i]->draw_count;
+        priv->nb_draws += spec->culled ? nodes[i]->cull_count
+                                       : nodes[i]->draw_count - nodes[i]->cull_count;
 }
 
 /* Draw utils */
@@ -1241,8 +1250,10 @@ static void widget_drawcall_reset_draws(struct widget *widget)
     for (int i = 0; i < NB_DRAWCALL; i++) {
         struct darray *nodes_array = &priv->nodes;
         struct ngl_node **nodes = ngli_darray_data(nodes_array);
-        for (int i = 0; i < ngli_darray_count(nodes_array); i++)
+        for (int i = 0; i < ngli_darray_count(nodes_array); i++) {
             nodes[i]->draw_count = 0;
+            nodes[i]->cull_count = 0;
+        }
     }
 }
 
@@ -1429,6 +1440,7 @@ static void hud_uninit(struct ngl_node *node)
 const struct node_class ngli_hud_class = {
     .id        = NGL_NODE_HUD,
     .name      = "HUD",
+    .flags     = NODE_FLAG_TIME_DEPENDENT,
     .init      = hud_init,
     .update    = hud_update,
     .draw      = hud_draw,
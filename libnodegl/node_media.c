@@ -298,6 +298,7 @@ static void media_uninit(struct ngl_node *node)
 const struct node_class ngli_media_class = {
     .id        = NGL_NODE_MEDIA,
     .name      = "Media",
+    .flags     = NODE_FLAG_TIME_DEPENDENT | NODE_FLAG_ASYNC_PREFETCH,
     .init      = media_init,
     .prefetch  = media_prefetch,
     .update    = media_update,
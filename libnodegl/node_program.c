@@ -96,20 +96,18 @@ static const struct node_param program_params[] = {
     {NULL}
 };
 
-static int program_init(struct ngl_node *node)
+static int program_pre_init(struct ngl_node *node)
 {
-    struct ngl_ctx *ctx = node->ctx;
-    struct glcontext *gl = ctx->glcontext;
     struct program_priv *s = node->priv_data;
+    return ngli_program_build_start(node->ctx, s->vertex, s->fragment, NULL);
+}
 
-    s->program_id = ngli_program_load(gl, s->vertex, s->fragment);
-    if (!s->program_id)
-        return -1;
+static int program_init(struct ngl_node *node)
+{
+    struct program_priv *s = node->priv_data;
 
-    s->active_uniforms = ngli_program_probe_uniforms(node->label, gl, s->program_id);
-    s->active_attributes = ngli_program_probe_attributes(node->label, gl, s->program_id);
-    s->active_buffer_blocks = ngli_program_probe_buffer_blocks(node->label, gl, s->program_id);
-    if (!s->active_uniforms || !s->active_attributes || !s->active_buffer_blocks)
+    s->program = ngli_program_get(node->ctx, node->label, s->vertex, s->fragment, NULL);
+    if (!s->program)
         return -1;
 
     return 0;
@@ -117,19 +115,16 @@ static int program_init(struct ngl_node *node)
 
 static void program_uninit(struct ngl_node *node)
 {
-    struct ngl_ctx *ctx = node->ctx;
-    struct glcontext *gl = ctx->glcontext;
     struct program_priv *s = node->priv_data;
 
-    ngli_hmap_freep(&s->active_uniforms);
-    ngli_hmap_freep(&s->active_attributes);
-    ngli_hmap_freep(&s->active_buffer_blocks);
-    ngli_glDeleteProgram(gl, s->program_id);
+    ngli_program_unrefp(node->ctx, &s->program);
 }
 
 const struct node_class ngli_program_class = {
     .id        = NGL_NODE_PROGRAM,
     .name      = "Program",
+    .flags     = NODE_FLAG_REUSABLE,
+    .pre_init  = program_pre_init,
     .init      = program_init,
     .uninit    = program_uninit,
     .priv_size = sizeof(struct program_priv),
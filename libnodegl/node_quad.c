@@ -105,6 +105,8 @@ static int quad_init(struct ngl_node *node)
 
     s->topology = GL_TRIANGLE_FAN;
 
+    ngli_node_geometry_compute_bbox(s);
+
     return 0;
 }
 
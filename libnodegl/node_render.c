@@ -95,6 +95,8 @@ static const struct node_param render_params[] = {
     {"uniforms", PARAM_TYPE_NODEDICT, OFFSET(pipeline.uniforms),
                  .node_types=UNIFORMS_TYPES_LIST,
                  .desc=NGLI_DOCSTRING("uniforms made accessible to the `program`")},
+    {"uniforms_block", PARAM_TYPE_STR, OFFSET(pipeline.uniforms_block),
+                       .desc=NGLI_DOCSTRING("name of a `std140` uniform block of the `program` in which the matching `uniforms` are packed and uploaded as a single buffer")},
     {"buffers",  PARAM_TYPE_NODEDICT, OFFSET(pipeline.buffers),
                  .node_types=BUFFERS_TYPES_LIST,
                  .desc=NGLI_DOCSTRING("buffers made accessible to the `program`")},
@@ -106,6 +108,12 @@ static const struct node_param render_params[] = {
                  .desc=NGLI_DOCSTRING("per instance extra vertex attributes made accessible to the `program`")},
     {"nb_instances", PARAM_TYPE_INT, OFFSET(nb_instances),
                  .desc=NGLI_DOCSTRING("number of instances to draw")},
+    {"frustum_culling", PARAM_TYPE_BOOL, OFFSET(frustum_culling),
+                        .desc=NGLI_DOCSTRING("skip the draw when the bounding box of the `geometry` is entirely "
+                                             "outside of the view; must only be enabled if the `program` positions "
+                                             "the vertices with the projection and modelview matrices; "
+                                             "ignored when drawing several instances or with "
+                                             "`instance_attributes`")},
     {NULL}
 };
 
@@ -114,16 +122,20 @@ static int update_geometry_uniforms(struct ngl_node *node)
     struct ngl_ctx *ctx = node->ctx;
     struct glcontext *gl = ctx->glcontext;
     struct render_priv *s = node->priv_data;
+    const struct program_priv *program_priv = s->pipeline.program->priv_data;
+    struct program *program = program_priv->program;
 
     const float *modelview_matrix = ngli_darray_tail(&ctx->modelview_matrix_stack);
     const float *projection_matrix = ngli_darray_tail(&ctx->projection_matrix_stack);
 
     if (s->modelview_matrix_location >= 0) {
-        ngli_glUniformMatrix4fv(gl, s->modelview_matrix_location, 1, GL_FALSE, modelview_matrix);
+        ngli_program_upload_uniform(gl, program, s->modelview_matrix_location,
+                                    GL_FLOAT_MAT4, 1, modelview_matrix);
     }
 
     if (s->projection_matrix_location >= 0) {
-        ngli_glUniformMatrix4fv(gl, s->projection_matrix_location, 1, GL_FALSE, projection_matrix);
+        ngli_program_upload_uniform(gl, program, s->projection_matrix_location,
+                                    GL_FLOAT_MAT4, 1, projection_matrix);
     }
 
     if (s->normal_matrix_location >= 0) {
@@ -131,7 +143,8 @@ static int update_geometry_uniforms(struct ngl_node *node)
         ngli_mat3_from_mat4(normal_matrix, modelview_matrix);
         ngli_mat3_inverse(normal_matrix, normal_matrix);
         ngli_mat3_transpose(normal_matrix, normal_matrix);
-        ngli_glUniformMatrix3fv(gl, s->normal_matrix_location, 1, GL_FALSE, normal_matrix);
+        ngli_program_upload_uniform(gl, program, s->normal_matrix_location,
+                                    GL_FLOAT_MAT3, 1, normal_matrix);
     }
 
     return 0;
@@ -202,7 +215,8 @@ static int pair_node_to_attribinfo(struct render_priv *s,
                                    struct ngl_node *anode)
 {
     const struct ngl_node *pnode = s->pipeline.program;
-    const struct program_priv *program = pnode->priv_data;
+    const struct program_priv *program_priv = pnode->priv_data;
+    const struct program *program = program_priv->program;
     const struct attributeprograminfo *active_attribute =
         ngli_hmap_get(program->active_attributes, name);
     if (!active_attribute)
@@ -361,8 +375,8 @@ static int render_init(struct ngl_node *node)
         return ret;
 
     struct ngl_node *pnode = s->pipeline.program;
-    struct program_priv *program = pnode->priv_data;
-    struct hmap *uniforms = program->active_uniforms;
+    struct program_priv *program_priv = pnode->priv_data;
+    struct hmap *uniforms = program_priv->program->active_uniforms;
 
     /* Instancing checks */
     if (s->nb_instances && !(gl->features & NGLI_FEATURE_DRAW_INSTANCED)) {
@@ -503,14 +517,61 @@ static int render_update(struct ngl_node *node, double t)
     return ngli_pipeline_update(node, t);
 }
 
+/*
+ * Whether the bounding box of the geometry, transformed by the current
+ * matrices, is entirely on the outer side of one of the clip volume planes
+ */
+static int is_culled(struct ngl_node *node)
+{
+    struct ngl_ctx *ctx = node->ctx;
+    const struct render_priv *s = node->priv_data;
+    const struct geometry_priv *geometry = s->geometry->priv_data;
+
+    /* The instances may be moved anywhere by the program */
+    if (s->nb_instances > 1 || s->instance_attributes || !geometry->has_bbox)
+        return 0;
+
+    const float *modelview_matrix = ngli_darray_tail(&ctx->modelview_matrix_stack);
+    const float *projection_matrix = ngli_darray_tail(&ctx->projection_matrix_stack);
+    NGLI_ALIGNED_MAT(mvp_matrix);
+    ngli_mat4_mul(mvp_matrix, projection_matrix, modelview_matrix);
+
+    int nb_outside[6] = {0};
+    for (int i = 0; i < 8; i++) {
+        const NGLI_ALIGNED_VEC(corner) = {
+            geometry->bbox[i      & 1][0],
+            geometry->bbox[i >> 1 & 1][1],
+            geometry->bbox[i >> 2 & 1][2],
+            1.0f,
+        };
+        NGLI_ALIGNED_VEC(clip);
+        ngli_mat4_mul_vec4(clip, mvp_matrix, corner);
+        for (int j = 0; j < 3; j++) {
+            nb_outside[2 * j]     += clip[j] < -clip[3];
+            nb_outside[2 * j + 1] += clip[j] >  clip[3];
+        }
+    }
+
+    for (int i = 0; i < NGLI_ARRAY_NB(nb_outside); i++)
+        if (nb_outside[i] == 8)
+            return 1;
+    return 0;
+}
+
 static void render_draw(struct ngl_node *node)
 {
     struct ngl_ctx *ctx = node->ctx;
     struct glcontext *gl = ctx->glcontext;
     struct render_priv *s = node->priv_data;
 
+    if (s->frustum_culling && is_culled(node)) {
+        TRACE("%s outside of the view, skip its draw", node->label);
+        node->cull_count++;
+        return;
+    }
+
     const struct program_priv *program = s->pipeline.program->priv_data;
-    ngli_glUseProgram(gl, program->program_id);
+    ngli_glUseProgram(gl, program->program->id);
 
     if (gl->features & NGLI_FEATURE_VERTEX_ARRAY_OBJECT) {
         ngli_glBindVertexArray(gl, s->vao_id);
@@ -259,7 +259,13 @@ static int texture_prefetch(struct ngl_node *node, int dimensions)
                     params->height = params->depth = 1;
                 }
             }
-            data = buffer->data;
+            /*
+             * Animated buffers are uploaded at every update, and their data
+             * may be changing while the texture is prefetched from the
+             * prefetch thread.
+             */
+            if (!(s->data_src->class->flags & NODE_FLAG_TIME_DEPENDENT))
+                data = buffer->data;
             params->format = buffer->data_format;
             break;
         }
@@ -376,6 +382,7 @@ static int texture3d_init(struct ngl_node *node)
 const struct node_class ngli_texture2d_class = {
     .id        = NGL_NODE_TEXTURE2D,
     .name      = "Texture2D",
+    .flags     = NODE_FLAG_ASYNC_PREFETCH,
     .prefetch  = texture2d_prefetch,
     .update    = texture_update,
     .release   = texture_release,
@@ -387,6 +394,7 @@ const struct node_class ngli_texture2d_class = {
 const struct node_class ngli_texture3d_class = {
     .id        = NGL_NODE_TEXTURE3D,
     .name      = "Texture3D",
+    .flags     = NODE_FLAG_ASYNC_PREFETCH,
     .init      = texture3d_init,
     .prefetch  = texture3d_prefetch,
     .update    = texture_update,
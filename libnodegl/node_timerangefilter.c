@@ -20,6 +20,7 @@
  */
 
 #include <float.h>
+#include <math.h>
 #include <stddef.h>
 #include <string.h>
 
@@ -28,17 +29,6 @@
 #include "nodes.h"
 #include "params.h"
 
-struct timerangefilter_priv {
-    struct ngl_node *child;
-    struct ngl_node **ranges;
-    int nb_ranges;
-    int current_range;
-    double prefetch_time;
-    double max_idle_time;
-
-    int drawme;
-};
-
 #define RANGES_TYPES_LIST (const int[]){NGL_NODE_TIMERANGEMODEONCE,     \
                                         NGL_NODE_TIMERANGEMODENOOP,     \
                                         NGL_NODE_TIMERANGEMODECONT,     \
@@ -46,7 +36,7 @@ struct timerangefilter_priv {
 
 #define OFFSET(x) offsetof(struct timerangefilter_priv, x)
 static const struct node_param timerangefilter_params[] = {
-    {"child", PARAM_TYPE_NODE, OFFSET(child), .flags=PARAM_FLAG_CONSTRUCTOR,
+    {"child", PARAM_TYPE_NODE, OFFSET(child), .flags=PARAM_FLAG_CONSTRUCTOR|PARAM_FLAG_LAZY_INIT,
               .desc=NGLI_DOCSTRING("time filtered scene")},
     {"ranges", PARAM_TYPE_NODELIST, OFFSET(ranges),
                .node_types=RANGES_TYPES_LIST,
@@ -131,10 +121,59 @@ static int update_rr_state(struct timerangefilter_priv *s, double t)
     return rr_id;
 }
 
+/*
+ * Restrict the interval of time around t in which the activity of the child
+ * is known not to change, so the context can skip the visit of the scene
+ * until t leaves it.
+ */
+static void restrict_activity_interval(struct ngl_ctx *ctx,
+                                       const struct timerangefilter_priv *s,
+                                       int rr_id, double t)
+{
+    double start = -DBL_MAX;
+    double end = DBL_MAX;
+
+    if (rr_id >= 0) {
+        const struct timerangemode_priv *rr = s->ranges[rr_id]->priv_data;
+        start = rr->start_time;
+    }
+
+    if (rr_id < s->nb_ranges - 1) {
+        const struct timerangemode_priv *next = s->ranges[rr_id + 1]->priv_data;
+        end = next->start_time;
+
+        /*
+         * Prefetch and idle thresholds of the next range, see visit(): the
+         * activity changes right after them (strict comparison), so the
+         * threshold itself belongs to the interval before it.
+         */
+        if (rr_id >= 0 && s->ranges[rr_id]->class->id == NGL_NODE_TIMERANGEMODENOOP) {
+            const double thresholds[] = {
+                next->start_time - s->max_idle_time,
+                next->start_time - s->prefetch_time,
+            };
+            for (int i = 0; i < NGLI_ARRAY_NB(thresholds); i++) {
+                const double after = nextafter(thresholds[i], DBL_MAX);
+                if (thresholds[i] < t)
+                    start = NGLI_MAX(start, after);
+                else
+                    end = NGLI_MIN(end, after);
+            }
+        }
+    }
+
+    ctx->activity_start = NGLI_MAX(ctx->activity_start, start);
+    ctx->activity_end   = NGLI_MIN(ctx->activity_end, end);
+}
+
 static int timerangefilter_visit(struct ngl_node *node, int is_active, double t)
 {
+    struct ngl_ctx *ctx = node->ctx;
     struct timerangefilter_priv *s = node->priv_data;
     struct ngl_node *child = s->child;
+    int time_remap = 0;
+    int lookahead = 0;
+    double next_use = 0.;
 
     /*
      * The life of the parent takes over the life of its children: if the
@@ -144,6 +183,8 @@ static int timerangefilter_visit(struct ngl_node *node, int is_active, double t)
     if (is_active) {
         const int rr_id = update_rr_state(s, t);
 
+        restrict_activity_interval(ctx, s, rr_id, t);
+
         if (rr_id >= 0) {
             struct ngl_node *rr = s->ranges[rr_id];
 
@@ -165,6 +206,8 @@ static int timerangefilter_visit(struct ngl_node *node, int is_active, double t)
                         // The node will actually be needed soon, so we need to
                         // start it if necessary.
                         is_active = 1;
+                        lookahead = 1;
+                        next_use = next_use_in;
                     } else if (next_use_in < s->max_idle_time && child->state == STATE_READY) {
                         TRACE("%s not currently needed by will be soon %g (< %g), keep as active",
                               child->label, next_use_in, s->max_idle_time);
@@ -175,6 +218,8 @@ static int timerangefilter_visit(struct ngl_node *node, int is_active, double t)
                         // already active it's not worth releasing it to start
                         // it again soon after, so we keep it active.
                         is_active = 1;
+                        lookahead = 1;
+                        next_use = next_use_in;
                     }
                 }
             } else if (rr->class->id == NGL_NODE_TIMERANGEMODEONCE) {
@@ -185,20 +230,36 @@ static int timerangefilter_visit(struct ngl_node *node, int is_active, double t)
                     struct timerangemode_priv *rro = rr->priv_data;
                     rro->updated = 0;
                 }
+
+                // The child is updated at the render time of the range (and
+                // only once), not at the current time.
+                time_remap = 1;
             }
         }
     }
 
-    return ngli_node_visit(child, is_active, t);
+    ctx->visit_time_remap += time_remap;
+    /*
+     * A child nested in several lookahead branches is only needed once all
+     * of them are, so the latest next use takes over.
+     */
+    const double visit_next_use = ctx->visit_next_use;
+    ctx->visit_next_use = NGLI_MAX(visit_next_use, next_use);
+    ctx->visit_lookahead += lookahead;
+    int ret = ngli_node_visit(child, is_active, t);
+    ctx->visit_lookahead -= lookahead;
+    ctx->visit_next_use = visit_next_use;
+    ctx->visit_time_remap -= time_remap;
+    return ret;
 }
 
-static int timerangefilter_update(struct ngl_node *node, double t)
+int ngli_timerangefilter_update_state(struct ngl_node *node, double *t)
 {
     struct timerangefilter_priv *s = node->priv_data;
 
     s->drawme = 0;
 
-    const int rr_id = update_rr_state(s, t);
+    const int rr_id = update_rr_state(s, *t);
     if (rr_id >= 0) {
         struct ngl_node *rr = s->ranges[rr_id];
 
@@ -209,12 +270,21 @@ static int timerangefilter_update(struct ngl_node *node, double t)
             struct timerangemode_priv *rro = rr->priv_data;
             if (rro->updated)
                 return 0;
-            t = rro->render_time;
+            *t = rro->render_time;
             rro->updated = 1;
         }
     }
 
     s->drawme = 1;
+    return 1;
+}
+
+static int timerangefilter_update(struct ngl_node *node, double t)
+{
+    struct timerangefilter_priv *s = node->priv_data;
+
+    if (!ngli_timerangefilter_update_state(node, &t))
+        return 0;
 
     struct ngl_node *child = s->child;
     return ngli_node_update(child, t);
@@ -236,6 +306,7 @@ static void timerangefilter_draw(struct ngl_node *node)
 const struct node_class ngli_timerangefilter_class = {
     .id        = NGL_NODE_TIMERANGEFILTER,
     .name      = "TimeRangeFilter",
+    .flags     = NODE_FLAG_TIME_DEPENDENT,
     .init      = timerangefilter_init,
     .visit     = timerangefilter_visit,
     .update    = timerangefilter_update,
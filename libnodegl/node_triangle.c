@@ -87,6 +87,8 @@ static int triangle_init(struct ngl_node *node)
 
     s->topology = GL_TRIANGLES;
 
+    ngli_node_geometry_compute_bbox(s);
+
     return 0;
 }
 
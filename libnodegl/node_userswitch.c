@@ -24,12 +24,7 @@
 #include "nodes.h"
 #include "params.h"
 
-struct userswitch {
-    struct ngl_node *child;
-    int enabled;
-};
-
-#define OFFSET(x) offsetof(struct userswitch, x)
+#define OFFSET(x) offsetof(struct userswitch_priv, x)
 static const struct node_param userswitch_params[] = {
     {"child",  PARAM_TYPE_NODE, OFFSET(child),
                .flags=PARAM_FLAG_CONSTRUCTOR,
@@ -42,19 +37,19 @@ static const struct node_param userswitch_params[] = {
 
 static int userswitch_visit(struct ngl_node *node, int is_active, double t)
 {
-    struct userswitch *s = node->priv_data;
+    struct userswitch_priv *s = node->priv_data;
     return ngli_node_visit(s->child, is_active && s->enabled, t);
 }
 
 static int userswitch_update(struct ngl_node *node, double t)
 {
-    struct userswitch *s = node->priv_data;
+    struct userswitch_priv *s = node->priv_data;
     return s->enabled ? ngli_node_update(s->child, t) : 0;
 }
 
 static void userswitch_draw(struct ngl_node *node)
 {
-    struct userswitch *s = node->priv_data;
+    struct userswitch_priv *s = node->priv_data;
     if (s->enabled)
         ngli_node_draw(s->child);
 }
@@ -65,7 +60,7 @@ const struct node_class ngli_userswitch_class = {
     .visit     = userswitch_visit,
     .update    = userswitch_update,
     .draw      = userswitch_draw,
-    .priv_size = sizeof(struct userswitch),
+    .priv_size = sizeof(struct userswitch_priv),
     .params    = userswitch_params,
     .file      = __FILE__,
 };
@@ -84,6 +84,16 @@ void ngl_log_set_min_level(int level);
  */
 struct ngl_node;
 
+/**
+ * Memory statistics of a context or a node, see ngl_get_memory_stats()
+ */
+struct ngl_memory_stats;
+
+/**
+ * Opaque structure identifying a node arena, see ngl_arena_create()
+ */
+struct ngl_arena;
+
 #define NGLI_FOURCC(a,b,c,d) (((uint32_t)(a))<<24 | (b)<<16 | (c)<<8 | (d))
 
 /**
@@ -175,6 +185,10 @@ struct ngl_node;
  *
  * Must be destroyed using ngl_node_unrefp().
  *
+ * This function is thread-safe: independent parts of a graph can be created
+ * from different threads and then joined (see ngl_node_param_set() and
+ * ngl_node_param_add()).
+ *
  * @param type  identify the node (any of NGL_NODE_*)
  * @param ...   variable arguments specific to the node type, refer to the
  *              constructors in the reference documentation for the expected
@@ -184,10 +198,57 @@ struct ngl_node;
  */
 struct ngl_node *ngl_node_create(int type, ...);
 
+/**
+ * Allocate an arena in which nodes can be created in bulk.
+ *
+ * Nodes created in an arena are packed together in large memory chunks,
+ * along with their private data, instead of being allocated one by one.
+ * Their memory is released all at once when the arena and all the nodes
+ * created in it are destroyed: each node holds a reference on its arena.
+ * Parameter payloads (labels, strings, data, lists) remain individually
+ * allocated since they can be changed at any time.
+ *
+ * An arena is meant for a graph with a common lifetime (typically a scene):
+ * a single node outliving the others keeps the whole arena alive.
+ *
+ * An arena must not be used to create nodes from several threads at the
+ * same time.
+ *
+ * Must be destroyed using ngl_arena_unrefp().
+ *
+ * @return a new allocated arena or NULL on error
+ */
+struct ngl_arena *ngl_arena_create(void);
+
+/**
+ * Drop the reference of the caller on the arena and set the pointer to NULL.
+ * The arena memory is released once all the nodes created in it are
+ * destroyed as well.
+ *
+ * This function is thread-safe.
+ *
+ * @param arenap  pointer to the pointer to the target arena
+ */
+void ngl_arena_unrefp(struct ngl_arena **arenap);
+
+/**
+ * Allocate a node in an arena. Apart from its allocation, the node behaves
+ * exactly as one allocated with ngl_node_create().
+ *
+ * @param arena  arena allocated with ngl_arena_create()
+ * @param type   identify the node (any of NGL_NODE_*)
+ * @param ...    variable arguments specific to the node type
+ *
+ * @return a new allocated node or NULL on error
+ *
+ * @see ngl_arena_create()
+ */
+struct ngl_node *ngl_node_create_arena(struct ngl_arena *arena, int type, ...);
+
 /**
  * Increment the reference counter of a given node by 1.
  *
- * This function is NOT thread-safe.
+ * This function is thread-safe.
  *
  * This function does not perform any OpenGL operation.
  *
@@ -202,6 +263,8 @@ struct ngl_node *ngl_node_ref(struct ngl_node *node);
  * content if the reference counter reaches 0. The passed node pointer will
  * also be set to NULL.
  *
+ * This function is thread-safe.
+ *
  * @param nodep  pointer to the pointer to the target node
  */
 void ngl_node_unrefp(struct ngl_node **nodep);
@@ -212,6 +275,11 @@ void ngl_node_unrefp(struct ngl_node **nodep);
  * If the type of the parameter is node based, the reference counter of the
  * passed nodes will be incremented.
  *
+ * Different nodes can be changed concurrently from different threads, even
+ * if they share children, as long as they are not associated with a node.gl
+ * context. A given node must not be changed from several threads at the same
+ * time.
+ *
  * @param node      pointer to the target node
  * @param key       string identifying the parameter
  * @param nb_elems  number of elements to append
@@ -228,6 +296,8 @@ int ngl_node_param_add(struct ngl_node *node, const char *key,
  * If the type of the parameter is node based, the reference counter of the
  * passed node will be incremented.
  *
+ * The same thread-safety rules as ngl_node_param_add() apply.
+ *
  * @param node      pointer to the target node
  * @param key       string identifying the parameter
  * @param ...       the value in parameter type
@@ -247,6 +317,20 @@ int ngl_node_param_set(struct ngl_node *node, const char *key, ...);
  */
 char *ngl_node_dot(const struct ngl_node *node);
 
+/**
+ * Get the memory currently held by a node on its own (its children are not
+ * included). The statistics are zero if the node is not associated with a
+ * node.gl context.
+ *
+ * @param node   pointer to the target node
+ * @param stats  pointer to the statistics to fill
+ *
+ * @return 0 on success, < 0 on error
+ *
+ * @see ngl_get_memory_stats()
+ */
+int ngl_node_get_memory_stats(const struct ngl_node *node, struct ngl_memory_stats *stats);
+
 /**
  * Serialize in node.gl format (.ngl).
  *
@@ -263,10 +347,25 @@ char *ngl_node_serialize(const struct ngl_node *node);
  *
  * Must be destroyed using ngl_node_unrefp().
  *
+ * This function is thread-safe.
+ *
  * @return a pointer to the de-serialized node graph or NULL on error
  */
 struct ngl_node *ngl_node_deserialize(const char *s);
 
+/**
+ * De-serialize a scene into an arena, see ngl_node_deserialize() and
+ * ngl_arena_create().
+ *
+ * This function is not thread-safe with regard to the arena.
+ *
+ * @param arena  arena allocated with ngl_arena_create()
+ * @param s      string in node.gl serialized format.
+ *
+ * @return a pointer to the de-serialized node graph or NULL on error
+ */
+struct ngl_node *ngl_node_deserialize_arena(struct ngl_arena *arena, const char *s);
+
 /**
  * Platform-specific identifiers
  */
@@ -322,6 +421,47 @@ struct ngl_config {
     int set_surface_pts; /* Whether pts should be set to the surface or not (Android only) */
 
     float clear_color[4]; /* Clear color (red, green, blue, alpha) */
+
+    int compiled_scene; /* Whether the scene should be compiled into a flat
+                           execution plan of update and draw operations instead
+                           of being traversed recursively at every frame */
+
+    int nb_update_threads; /* Number of threads (including the rendering one)
+                              used to run the CPU-only updates of the scene,
+                              such as the animations evaluation, in parallel.
+                              0 or 1 keeps the update entirely serial */
+
+    int lazy_init; /* Whether the initialization of the nodes should be
+                      deferred to their first activation (including the
+                      prefetch period of the time range filters) instead of
+                      happening in ngl_set_scene(); initialization errors are
+                      then reported by the draw functions */
+
+    int prefetch_thread; /* Whether the prefetch of the nodes ahead of their
+                            use (texture uploads, media start, ...) should be
+                            done from a separate thread with its own GL context
+                            sharing the objects of the main one; falls back to
+                            prefetching synchronously if the platform does not
+                            support it */
+
+    double prefetch_budget; /* Maximum time (in seconds) spent per frame on the
+                               prefetch of the nodes which are not needed yet,
+                               the soonest needed being prefetched first; the
+                               remaining ones are postponed to the next frames
+                               unless they become needed. 0 means unlimited */
+
+    int hot_swap; /* Whether ngl_set_scene() should reuse the initialized
+                     nodes of the previous scene (such as the compiled
+                     programs) for the nodes of the new scene with the same
+                     type and parameters, instead of initializing them again */
+
+    const char *program_cache_dir; /* Existing directory in which the binaries
+                                      of the built programs are cached and
+                                      reused by the next contexts instead of
+                                      building the programs again, NULL to
+                                      disable the cache. Ignored if the
+                                      driver does not support program
+                                      binaries */
 };
 
 /**
@@ -370,6 +510,10 @@ int ngl_configure(struct ngl_ctx *s, struct ngl_config *config);
  *
  * To only detach the currently associated scene, scene=NULL can be used.
  *
+ * If hot_swap is enabled in the configuration, the nodes of the new scene
+ * identical to initialized nodes of the previous one take over their state
+ * (see ngl_config.hot_swap).
+ *
  * @param s      pointer to the configured node.gl context
  * @param scene  pointer to the scene
  *
@@ -391,6 +535,261 @@ int ngl_set_scene(struct ngl_ctx *s, struct ngl_node *scene);
  */
 int ngl_draw(struct ngl_ctx *s, double t);
 
+/**
+ * Frame completion callback prototype, used by ngl_draw_range().
+ *
+ * @param user_arg     forwarded opaque user argument
+ * @param frame_index  index of the frame in the range, starting at 0
+ * @param t            time at which the frame was drawn
+ *
+ * @return 0 to continue with the next frame, < 0 to stop the range (the
+ *         value is returned by ngl_draw_range())
+ */
+typedef int (*ngl_frame_callback_type)(void *user_arg, int frame_index, double t);
+
+/**
+ * Draw all the frames at t0 + i/rate (for i = 0, 1, 2, ...) strictly below
+ * t1, within a single dispatch to the rendering thread.
+ *
+ * This is equivalent to calling ngl_draw() for each of these times, without
+ * the handoff between the calling and the rendering threads at every frame.
+ *
+ * @param s         pointer to the configured node.gl context
+ * @param t0        time of the first frame in seconds
+ * @param t1        end time (excluded) of the range in seconds
+ * @param rate      number of frames per second (must be positive)
+ * @param callback  optional function called after every frame is drawn, for
+ *                  instance once the Camera pipe_fd readback of the frame is
+ *                  done. Note that it is called from the rendering thread.
+ * @param user_arg  opaque user argument to be forwarded to the callback
+ *
+ * @return 0 on success, < 0 on error
+ */
+int ngl_draw_range(struct ngl_ctx *s, double t0, double t1, double rate,
+                   ngl_frame_callback_type callback, void *user_arg);
+
+/**
+ * Queue a draw at the specified time and return without waiting for it to
+ * complete, so the caller can prepare the next frame while the current one is
+ * being rendered.
+ *
+ * At most 4 frames can be in flight: if the queue is full, this function
+ * blocks until the oldest frame completes. The other functions working on the
+ * context (such as ngl_draw() or ngl_set_scene()) wait for the queued frames
+ * to complete first.
+ *
+ * Errors happening during the draw are not reported by this function but by
+ * ngl_wait().
+ *
+ * @param s     pointer to the configured node.gl context
+ * @param t     target draw time in seconds
+ *
+ * @note the nodes of the scene (including their parameters) must not be
+ *       modified until ngl_wait() returns.
+ *
+ * @return 0 on success, < 0 on error
+ *
+ * @see ngl_wait()
+ */
+int ngl_draw_async(struct ngl_ctx *s, double t);
+
+/**
+ * Wait for all the draws queued with ngl_draw_async() to complete.
+ *
+ * @param s     pointer to the node.gl context
+ *
+ * @return 0 if all the queued draws succeeded, otherwise the error of the
+ *         first one which failed (< 0)
+ */
+int ngl_wait(struct ngl_ctx *s);
+
+/**
+ * Memory categories of the objects allocated by a node.gl context
+ */
+enum {
+    NGL_MEMORY_BUFFERS,            /* GPU buffers (vertices, indices, blocks, ...) */
+    NGL_MEMORY_TEXTURES,           /* GPU textures, including their mipmaps */
+    NGL_MEMORY_RENDERBUFFERS,      /* single-sampled GPU renderbuffers */
+    NGL_MEMORY_RENDERBUFFERS_MSAA, /* multisampled GPU renderbuffers */
+    NGL_MEMORY_FRAMEBUFFERS,       /* framebuffer objects, which do not hold
+                                      any storage on their own (their
+                                      attachments are accounted as textures
+                                      or renderbuffers) */
+    NGL_MEMORY_BUFFERS_CPU,        /* CPU data of the buffer nodes */
+    NGL_NB_MEMORY
+};
+
+/**
+ * Memory statistics, indexed by NGL_MEMORY_*
+ */
+struct ngl_memory_stats {
+    int64_t sizes[NGL_NB_MEMORY]; /* number of bytes currently allocated */
+    int counts[NGL_NB_MEMORY];    /* number of objects currently allocated */
+};
+
+/**
+ * Start a batch of live parameter changes.
+ *
+ * Until the batch is committed, ngl_node_param_set() does not apply the
+ * changes of the parameters of the nodes attached to the context but queues
+ * them in the batch, keeping a reference on the changed nodes until the batch
+ * is applied.
+ *
+ * A batch is not thread-safe: between ngl_param_batch_begin() and
+ * ngl_param_batch_commit(), the changes of the nodes attached to the context
+ * must all be made from a single thread.
+ *
+ * @param s  pointer to the node.gl context
+ *
+ * @return 0 on success, < 0 on error
+ *
+ * @see ngl_param_batch_commit()
+ */
+int ngl_param_batch_begin(struct ngl_ctx *s);
+
+/**
+ * Commit the batch of live parameter changes started with
+ * ngl_param_batch_begin().
+ *
+ * All the changes of the batch are applied together by the rendering thread
+ * before the next frame is prepared (or the next scene set), so a frame never
+ * reflects only a part of them. The commit does not wait for the rendering
+ * thread and does not take any lock.
+ *
+ * The batch must be committed before calling ngl_set_scene().
+ *
+ * @param s  pointer to the node.gl context
+ *
+ * @return 0 on success, < 0 on error
+ */
+int ngl_param_batch_commit(struct ngl_ctx *s);
+
+/**
+ * Get the memory currently held by a node.gl context, including the objects
+ * which are not tied to a node (such as the offscreen framebuffer).
+ *
+ * Sizes are computed from the dimensions and formats of the objects, so
+ * they do not include the driver overhead such as padding or alignment.
+ *
+ * @param s      pointer to the configured node.gl context
+ * @param stats  pointer to the statistics to fill
+ *
+ * @return 0 on success, < 0 on error
+ *
+ * @see ngl_node_get_memory_stats()
+ */
+int ngl_get_memory_stats(struct ngl_ctx *s, struct ngl_memory_stats *stats);
+
+/**
+ * Statistics of the program binary cache, see ngl_config.program_cache_dir
+ */
+struct ngl_program_cache_stats {
+    int hits;   /* programs loaded from their cached binary */
+    int misses; /* programs built because they were not in the cache */
+    int stale;  /* cached binaries rejected by the driver (or corrupted),
+                   the programs have been built instead */
+};
+
+/**
+ * Get the statistics of the program binary cache of a node.gl context.
+ *
+ * All the statistics are zero if the cache is disabled.
+ *
+ * @param s      pointer to the configured node.gl context
+ * @param stats  pointer to the statistics to fill
+ *
+ * @return 0 on success, < 0 on error
+ */
+int ngl_get_program_cache_stats(struct ngl_ctx *s, struct ngl_program_cache_stats *stats);
+
+/**
+ * Uniform upload statistics, accumulated since the context configuration
+ */
+struct ngl_uniform_stats {
+    int64_t issued;  /* uploads issued to the driver */
+    int64_t skipped; /* uploads skipped because the program already held the
+                        exact same values */
+};
+
+/**
+ * Get the uniform upload statistics of a node.gl context.
+ *
+ * @param s      pointer to the configured node.gl context
+ * @param stats  pointer to the statistics to fill
+ *
+ * @return 0 on success, < 0 on error
+ */
+int ngl_get_uniform_stats(struct ngl_ctx *s, struct ngl_uniform_stats *stats);
+
+/**
+ * GL binding statistics (programs, vertex arrays, textures, buffers,
+ * framebuffers and viewport), accumulated since the context configuration
+ */
+struct ngl_binding_stats {
+    int64_t issued; /* binding calls issued to the driver */
+    int64_t elided; /* binding calls skipped because the object was already
+                       bound */
+};
+
+/**
+ * Get the GL binding statistics of a node.gl context.
+ *
+ * @param s      pointer to the configured node.gl context
+ * @param stats  pointer to the statistics to fill
+ *
+ * @return 0 on success, < 0 on error
+ */
+int ngl_get_binding_stats(struct ngl_ctx *s, struct ngl_binding_stats *stats);
+
+/**
+ * State changes (GraphicConfig, program and textures) between the
+ * consecutive children of the initialized Group nodes with sorting enabled
+ */
+struct ngl_sort_stats {
+    int nb_groups;
+    int state_changes_unsorted; /* in the declaration order of the children */
+    int state_changes_sorted;   /* in the order the children are drawn */
+};
+
+/**
+ * Get the Group sorting statistics of a node.gl context.
+ *
+ * @param s      pointer to the configured node.gl context
+ * @param stats  pointer to the statistics to fill
+ *
+ * @return 0 on success, < 0 on error
+ */
+int ngl_get_sort_stats(struct ngl_ctx *s, struct ngl_sort_stats *stats);
+
+/**
+ * Start recording the lifecycle of the nodes (init, prefetch, update and
+ * draw) as well as the backend pre and post draw operations.
+ *
+ * Every operation is recorded as a pair of timestamped begin/end events
+ * tagged with the label and class of the node, from all the threads of the
+ * context. The trace is written in the Chrome trace event format (JSON),
+ * which can be loaded in chrome://tracing, when ngl_trace_stop() is called
+ * or the context is destroyed.
+ *
+ * @param s         pointer to the node.gl context
+ * @param filename  path of the trace file to write
+ *
+ * @return 0 on success, < 0 on error (including when a trace is already
+ *         being recorded)
+ *
+ * @see ngl_trace_stop()
+ */
+int ngl_trace_start(struct ngl_ctx *s, const char *filename);
+
+/**
+ * Stop recording the trace started with ngl_trace_start() and write it.
+ *
+ * @param s     pointer to the node.gl context
+ *
+ * @return 0 on success (or if no trace is being recorded), < 0 on error
+ */
+int ngl_trace_stop(struct ngl_ctx *s);
+
 /**
  * Serialize the current scene in Graphviz format (.dot) a node graph at the
  * specified time. Non active nodes will be grayed.
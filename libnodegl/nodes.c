@@ -26,6 +26,7 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "arena.h"
 #include "hmap.h"
 #include "log.h"
 #include "nodegl.h"
@@ -58,14 +59,22 @@ static void *aligned_allocz(size_t size)
     return ptr;
 }
 
-static struct ngl_node *node_create(const struct node_class *class)
+static struct ngl_node *node_create(struct ngl_arena *arena, const struct node_class *class)
 {
     struct ngl_node *node;
     const size_t node_size = NGLI_ALIGN(sizeof(*node), NGLI_ALIGN_VAL);
 
-    node = aligned_allocz(node_size + class->priv_size);
+    /*
+     * Nodes created in an arena are packed next to each other with their
+     * private data, and keep the arena alive until the last one is deleted.
+     */
+    if (arena)
+        node = ngli_arena_alloc(arena, node_size + class->priv_size);
+    else
+        node = aligned_allocz(node_size + class->priv_size);
     if (!node)
         return NULL;
+    node->arena = arena ? ngli_arena_ref(arena) : NULL;
     node->priv_data = ((uint8_t *)node) + node_size;
 
     /* Make sure the node and its private data are properly aligned */
@@ -121,7 +130,7 @@ static const struct node_class *get_node_class(int type)
     return NULL;
 }
 
-struct ngl_node *ngli_node_create_noconstructor(int type)
+struct ngl_node *ngli_node_create_noconstructor(struct ngl_arena *arena, int type)
 {
     const struct node_class *class = get_node_class(type);
     if (!class) {
@@ -129,7 +138,7 @@ struct ngl_node *ngli_node_create_noconstructor(int type)
         return NULL;
     }
 
-    struct ngl_node *node = node_create(class);
+    struct ngl_node *node = node_create(arena, class);
     if (!node)
         return NULL;
 
@@ -148,17 +157,13 @@ struct ngl_node *ngli_node_create_noconstructor(int type)
     return node;
 }
 
-struct ngl_node *ngl_node_create(int type, ...)
+static struct ngl_node *node_create_v(struct ngl_arena *arena, int type, va_list *ap)
 {
-    struct ngl_node *node = ngli_node_create_noconstructor(type);
+    struct ngl_node *node = ngli_node_create_noconstructor(arena, type);
     if (!node)
         return NULL;
 
-    va_list ap;
-    va_start(ap, type);
-    int ret = ngli_params_set_constructors(node->priv_data, node->class->params, &ap);
-    va_end(ap);
-
+    int ret = ngli_params_set_constructors(node->priv_data, node->class->params, ap);
     if (ret < 0) {
         ngl_node_unrefp(&node);
         return NULL;
@@ -169,8 +174,48 @@ struct ngl_node *ngl_node_create(int type, ...)
     return node;
 }
 
+struct ngl_node *ngl_node_create(int type, ...)
+{
+    va_list ap;
+    va_start(ap, type);
+    struct ngl_node *node = node_create_v(NULL, type, &ap);
+    va_end(ap);
+    return node;
+}
+
+struct ngl_node *ngl_node_create_arena(struct ngl_arena *arena, int type, ...)
+{
+    va_list ap;
+    va_start(ap, type);
+    struct ngl_node *node = node_create_v(arena, type, &ap);
+    va_end(ap);
+    return node;
+}
+
+/*
+ * Collect the prefetch of the node from the prefetch thread. Returns 1 if the
+ * node is now ready, 0 if it is still being prefetched (only if wait is 0).
+ */
+static int node_collect_prefetch(struct ngl_node *node, int wait)
+{
+    int ret = ngli_prefetcher_collect(node->ctx->prefetcher, node, wait);
+    if (!ret)
+        return 0;
+    node->prefetch_pending = 0;
+    if (ret < 0) {
+        LOG(ERROR, "prefetching node %s failed: %d", node->label, ret);
+        node->visit_time = -1.;
+        return ret;
+    }
+    node->state = STATE_READY;
+    return 1;
+}
+
 static void node_release(struct ngl_node *node)
 {
+    if (node->prefetch_pending)
+        node_collect_prefetch(node, 1);
+
     if (node->state != STATE_READY)
         return;
 
@@ -221,11 +266,157 @@ static void node_uninit(struct ngl_node *node)
     node->visit_time = -1.;
 }
 
+static void swap_bytes(uint8_t *a, uint8_t *b, size_t size)
+{
+    for (size_t i = 0; i < size; i++) {
+        const uint8_t tmp = a[i];
+        a[i] = b[i];
+        b[i] = tmp;
+    }
+}
+
+/*
+ * Exchange every field of the private data which is not a parameter between
+ * two nodes of the same class, see reset_non_params().
+ */
+static void swap_non_params(struct ngl_node *a, struct ngl_node *b)
+{
+    size_t cur_offset = 0;
+    const struct node_param *par = a->class->params;
+    uint8_t *base_ptr_a = a->priv_data;
+    uint8_t *base_ptr_b = b->priv_data;
+
+    ngli_assert(a->class == b->class);
+    while (par && par->key) {
+        size_t offset = par->offset;
+        if (offset != cur_offset)
+            swap_bytes(base_ptr_a + cur_offset, base_ptr_b + cur_offset, offset - cur_offset);
+        cur_offset = offset + ngli_params_specs[par->type].size;
+        par++;
+    }
+    swap_bytes(base_ptr_a + cur_offset, base_ptr_b + cur_offset, a->class->priv_size - cur_offset);
+}
+
+#define REUSABLE_KEY_SIZE 17
+
+static void get_reusable_key(const struct ngl_node *node, char *key)
+{
+    const uint32_t hash = ngli_params_hash(node->priv_data, node->class->params);
+    snprintf(key, REUSABLE_KEY_SIZE, "%08X%08X", node->class->id, hash);
+}
+
+static int node_is_reusable(const struct ngl_node *node)
+{
+    return node->ctx->reusable_nodes && (node->class->flags & NODE_FLAG_REUSABLE);
+}
+
+/*
+ * Keep the node being detached from the context initialized so an identical
+ * node of the next scene can take over its state. Only the first node of
+ * every key is kept.
+ */
+static int node_keep_reusable(struct ngl_node *node)
+{
+    if (!node_is_reusable(node) || node->state == STATE_UNINITIALIZED)
+        return 0;
+
+    char key[REUSABLE_KEY_SIZE];
+    get_reusable_key(node, key);
+    struct hmap *reusable_nodes = node->ctx->reusable_nodes;
+    if (ngli_hmap_get(reusable_nodes, key))
+        return 0;
+
+    node_release(node);
+    if (ngli_hmap_set(reusable_nodes, key, node) < 0)
+        return 0;
+    ngl_node_ref(node);
+
+    return 1;
+}
+
+/*
+ * Take over the state of an identical node kept initialized from the previous
+ * scene, see node_keep_reusable().
+ */
+static void node_reuse(struct ngl_node *node)
+{
+    if (!node_is_reusable(node) || node->ctx_refcount)
+        return;
+
+    char key[REUSABLE_KEY_SIZE];
+    get_reusable_key(node, key);
+    struct hmap *reusable_nodes = node->ctx->reusable_nodes;
+    struct ngl_node *prev = ngli_hmap_get(reusable_nodes, key);
+    if (!prev)
+        return;
+
+    /* The node is part of both scenes, it simply keeps its own state */
+    if (prev == node) {
+        ngli_hmap_set(reusable_nodes, key, NULL);
+        return;
+    }
+
+    if (node->state != STATE_UNINITIALIZED || prev->class != node->class ||
+        !ngli_params_equal(prev->priv_data, node->priv_data, node->class->params))
+        return;
+
+    LOG(VERBOSE, "REUSE %s @ %p for %s @ %p", prev->label, prev, node->label, node);
+
+    swap_non_params(node, prev);
+
+    const struct darray children = node->children;
+    node->children = prev->children;
+    prev->children = children;
+
+    node->state = prev->state;
+    node->is_static = prev->is_static;
+
+    prev->state = STATE_UNINITIALIZED;
+    prev->visit_time = -1.;
+    prev->ctx = NULL;
+    ngli_hmap_set(reusable_nodes, key, NULL);
+}
+
+static void reusable_node_free(void *user_arg, void *data)
+{
+    struct ngl_node *node = data;
+    ngl_node_unrefp(&node);
+}
+
+int ngli_node_reusable_init(struct ngl_ctx *ctx)
+{
+    ngli_assert(!ctx->reusable_nodes);
+    ctx->reusable_nodes = ngli_hmap_create();
+    if (!ctx->reusable_nodes)
+        return -1;
+    ngli_hmap_set_free(ctx->reusable_nodes, reusable_node_free, NULL);
+    return 0;
+}
+
+void ngli_node_reusable_reset(struct ngl_ctx *ctx)
+{
+    struct hmap *reusable_nodes = ctx->reusable_nodes;
+    if (!reusable_nodes)
+        return;
+
+    ctx->reusable_nodes = NULL;
+
+    const struct hmap_entry *entry = NULL;
+    while ((entry = ngli_hmap_next(reusable_nodes, entry))) {
+        struct ngl_node *node = entry->data;
+        node_uninit(node);
+        node->ctx = NULL;
+    }
+    ngli_hmap_freep(&reusable_nodes);
+}
+
 static int track_children(struct ngl_node *node)
 {
     uint8_t *base_ptr = node->priv_data;
     const struct node_param *par = node->class->params;
 
+    node->is_static = !(node->class->flags & NODE_FLAG_TIME_DEPENDENT);
+
     if (!par)
         return 0;
 
@@ -262,6 +453,11 @@ static int track_children(struct ngl_node *node)
         par++;
     }
 
+    /* Children are always initialized before their parent */
+    struct ngl_node **children = ngli_darray_data(&node->children);
+    for (int i = 0; i < ngli_darray_count(&node->children); i++)
+        node->is_static &= children[i]->is_static;
+
     return 0;
 }
 
@@ -275,7 +471,11 @@ static int node_init(struct ngl_node *node)
     ngli_assert(node->ctx);
     if (node->class->init) {
         LOG(VERBOSE, "INIT %s @ %p", node->label, node);
+        NGLI_TRACER_BEGIN(node->ctx->tracer, "init", node);
+        struct ngl_memory_stats *prev_owner = ngli_memstats_set_owner(&node->memstats);
         int ret = node->class->init(node);
+        ngli_memstats_set_owner(prev_owner);
+        NGLI_TRACER_END(node->ctx->tracer);
         if (ret < 0) {
             LOG(ERROR, "initializing node %s failed: %d", node->label, ret);
             node->state = STATE_INIT_FAILED;
@@ -296,19 +496,24 @@ static int node_init(struct ngl_node *node)
     return 0;
 }
 
-static int node_set_children_ctx(uint8_t *base_ptr, const struct node_param *params,
-                                 struct ngl_ctx *ctx)
+typedef int (*child_func_type)(struct ngl_node *node, void *arg);
+
+static int node_foreach_child(uint8_t *base_ptr, const struct node_param *params,
+                              int skip_flags, child_func_type child_func, void *arg)
 {
     if (!params)
         return 0;
     for (int i = 0; params[i].key; i++) {
         const struct node_param *par = &params[i];
 
+        if (par->flags & skip_flags)
+            continue;
+
         if (par->type == PARAM_TYPE_NODE) {
             uint8_t *node_p = base_ptr + par->offset;
             struct ngl_node *node = *(struct ngl_node **)node_p;
             if (node) {
-                int ret = ngli_node_attach_ctx(node, ctx);
+                int ret = child_func(node, arg);
                 if (ret < 0)
                     return ret;
             }
@@ -318,7 +523,7 @@ static int node_set_children_ctx(uint8_t *base_ptr, const struct node_param *par
             struct ngl_node **elems = *(struct ngl_node ***)elems_p;
             const int nb_elems = *(int *)nb_elems_p;
             for (int j = 0; j < nb_elems; j++) {
-                int ret = ngli_node_attach_ctx(elems[j], ctx);
+                int ret = child_func(elems[j], arg);
                 if (ret < 0)
                     return ret;
             }
@@ -329,7 +534,7 @@ static int node_set_children_ctx(uint8_t *base_ptr, const struct node_param *par
             const struct hmap_entry *entry = NULL;
             while ((entry = ngli_hmap_next(hmap, entry))) {
                 struct ngl_node *node = entry->data;
-                int ret = ngli_node_attach_ctx(node, ctx);
+                int ret = child_func(node, arg);
                 if (ret < 0)
                     return ret;
             }
@@ -338,8 +543,26 @@ static int node_set_children_ctx(uint8_t *base_ptr, const struct node_param *par
     return 0;
 }
 
-static int node_set_ctx(struct ngl_node *node, struct ngl_ctx *ctx)
+/*
+ * Start the work of the node init which can run in the background (such as
+ * the program builds) so it overlaps with the init of the other nodes.
+ */
+static int node_pre_init(struct ngl_node *node)
+{
+    if (node->state != STATE_UNINITIALIZED || !node->class->pre_init)
+        return 0;
+    return node->class->pre_init(node);
+}
+
+struct set_ctx_arg {
+    struct ngl_ctx *ctx;
+    int pre_init;
+};
+
+static int node_set_ctx(struct ngl_node *node, void *arg)
 {
+    const struct set_ctx_arg *set_ctx_arg = arg;
+    struct ngl_ctx *ctx = set_ctx_arg->ctx;
     int ret;
 
     if (ctx) {
@@ -348,21 +571,22 @@ static int node_set_ctx(struct ngl_node *node, struct ngl_ctx *ctx)
             return -1;
         }
     } else {
-        if (node->state > STATE_UNINITIALIZED && node->ctx_refcount-- == 1) {
+        if (node->ctx_refcount > 0 && node->ctx_refcount-- == 1 &&
+            !node_keep_reusable(node)) {
             node_uninit(node);
             node->ctx = NULL;
         }
         ngli_assert(node->ctx_refcount >= 0);
     }
 
-    if ((ret = node_set_children_ctx(node->priv_data, node->class->params, ctx)) < 0 ||
-        (ret = node_set_children_ctx((uint8_t *)node, ngli_base_node_params, ctx)) < 0)
+    if ((ret = node_foreach_child(node->priv_data, node->class->params, 0, node_set_ctx, arg)) < 0 ||
+        (ret = node_foreach_child((uint8_t *)node, ngli_base_node_params, 0, node_set_ctx, arg)) < 0)
         return ret;
 
     if (ctx) {
         node->ctx = ctx;
-        ret = node_init(node);
-        if (ret < 0) {
+        node_reuse(node);
+        if (set_ctx_arg->pre_init && (ret = node_pre_init(node)) < 0) {
             node->ctx = NULL;
             return ret;
         }
@@ -372,14 +596,78 @@ static int node_set_ctx(struct ngl_node *node, struct ngl_ctx *ctx)
     return 0;
 }
 
+static int node_pre_init_tree(struct ngl_node *node, void *arg)
+{
+    if (node->state != STATE_UNINITIALIZED)
+        return 0;
+
+    int ret = node_foreach_child(node->priv_data, node->class->params,
+                                 PARAM_FLAG_LAZY_INIT, node_pre_init_tree, NULL);
+    if (ret < 0)
+        return ret;
+
+    return node_pre_init(node);
+}
+
+static int node_init_tree(struct ngl_node *node, void *arg)
+{
+    if (node->state != STATE_UNINITIALIZED)
+        return 0;
+
+    /*
+     * Children are initialized before their parent, except the ones which are
+     * only initialized on their own first active visit.
+     */
+    int ret = node_foreach_child(node->priv_data, node->class->params,
+                                 PARAM_FLAG_LAZY_INIT, node_init_tree, NULL);
+    if (ret < 0)
+        return ret;
+
+    ret = node_init(node);
+    if (ret < 0)
+        return ret;
+
+    node->ctx->graph_changed = 1;
+    return 0;
+}
+
+/* Children are initialized before their parent */
+static int node_init_all(struct ngl_node *node, void *arg)
+{
+    if (node->state != STATE_UNINITIALIZED)
+        return 0;
+
+    int ret = node_foreach_child(node->priv_data, node->class->params, 0, node_init_all, NULL);
+    if (ret < 0)
+        return ret;
+
+    return node_init(node);
+}
+
+/*
+ * The whole graph is associated with the context and its pre-init started
+ * before any node is initialized. On error, the graph must be detached.
+ */
 int ngli_node_attach_ctx(struct ngl_node *node, struct ngl_ctx *ctx)
 {
-    return node_set_ctx(node, ctx);
+    struct set_ctx_arg arg = {.ctx = ctx, .pre_init = 1};
+    int ret = node_set_ctx(node, &arg);
+    if (ret < 0)
+        return ret;
+    return node_init_all(node, NULL);
+}
+
+/* With lazy init, the nodes are initialized when first visited as active */
+int ngli_node_attach_ctx_lazy(struct ngl_node *node, struct ngl_ctx *ctx)
+{
+    struct set_ctx_arg arg = {.ctx = ctx};
+    return node_set_ctx(node, &arg);
 }
 
 void ngli_node_detach_ctx(struct ngl_node *node)
 {
-    int ret = node_set_ctx(node, NULL);
+    struct set_ctx_arg arg = {0};
+    int ret = node_set_ctx(node, &arg);
     ngli_assert(ret == 0);
 }
 
@@ -398,6 +686,21 @@ int ngli_node_visit(struct ngl_node *node, int is_active, double t)
     if (!is_active && node->state == STATE_IDLE)
         return 0;
 
+    /*
+     * With lazy init, nodes are initialized on their first active visit,
+     * which includes the prefetch period of the time range filters.
+     */
+    if (node->state == STATE_UNINITIALIZED) {
+        if (!is_active)
+            return 0;
+        int ret = node_pre_init_tree(node, NULL);
+        if (ret < 0)
+            return ret;
+        ret = node_init_tree(node, NULL);
+        if (ret < 0)
+            return ret;
+    }
+
     const int queue_node = node->visit_time != t;
 
     if (queue_node) {
@@ -406,7 +709,10 @@ int ngli_node_visit(struct ngl_node *node, int is_active, double t)
          * active state takes over to replace the one from a previous update.
          */
         node->is_active = is_active;
+        node->is_needed = is_active && !node->ctx->visit_lookahead;
+        node->next_use_in = node->ctx->visit_next_use;
         node->visit_time = t;
+        node->visit_time_remapped = node->ctx->visit_time_remap > 0;
     } else {
         /*
          * This is not the first time we come across that node, so if it's
@@ -414,6 +720,10 @@ int ngli_node_visit(struct ngl_node *node, int is_active, double t)
          * get released.
          */
         node->is_active |= is_active;
+        node->is_needed |= is_active && !node->ctx->visit_lookahead;
+        if (is_active)
+            node->next_use_in = NGLI_MIN(node->next_use_in, node->ctx->visit_next_use);
+        node->visit_time_remapped |= node->ctx->visit_time_remap > 0;
     }
 
     if (node->class->visit) {
@@ -437,14 +747,38 @@ int ngli_node_visit(struct ngl_node *node, int is_active, double t)
     return 0;
 }
 
+static int node_prefetch_is_async(const struct ngl_node *node)
+{
+    return node->ctx->prefetcher && !node->is_needed && node->class->prefetch &&
+           (node->class->flags & NODE_FLAG_ASYNC_PREFETCH);
+}
+
 static int node_prefetch(struct ngl_node *node)
 {
     if (node->state == STATE_READY)
         return 0;
 
+    /* Only wait for the prefetch thread if the node is needed right now */
+    if (node->prefetch_pending) {
+        int ret = node_collect_prefetch(node, node->is_needed);
+        return NGLI_MIN(ret, 0);
+    }
+
+    if (node_prefetch_is_async(node)) {
+        int ret = ngli_prefetcher_push(node->ctx->prefetcher, node);
+        if (ret < 0)
+            return ret;
+        node->prefetch_pending = 1;
+        return 0;
+    }
+
     if (node->class->prefetch) {
         TRACE("PREFETCH %s @ %p", node->label, node);
+        NGLI_TRACER_BEGIN(node->ctx->tracer, "prefetch", node);
+        struct ngl_memory_stats *prev_owner = ngli_memstats_set_owner(&node->memstats);
         int ret = node->class->prefetch(node);
+        ngli_memstats_set_owner(prev_owner);
+        NGLI_TRACER_END(node->ctx->tracer);
         if (ret < 0) {
             LOG(ERROR, "prefetching node %s failed: %d", node->label, ret);
             node->visit_time = -1.;
@@ -456,13 +790,34 @@ static int node_prefetch(struct ngl_node *node)
     return 0;
 }
 
-int ngli_node_honor_release_prefetch(struct darray *nodes_array)
+/*
+ * Whether the prefetch of the node may be postponed to a later frame if the
+ * prefetch budget of the current one is exhausted: only the prefetches
+ * running on the rendering thread of nodes which are not needed yet are.
+ */
+static int node_prefetch_is_deferrable(const struct ngl_node *node)
 {
-    struct ngl_node **nodes = ngli_darray_data(nodes_array);
-    for (int i = 0; i < ngli_darray_count(nodes_array); i++) {
+    return node->ctx->config.prefetch_budget > 0. &&
+           node->state != STATE_READY && !node->is_needed &&
+           !node->prefetch_pending && node->class->prefetch &&
+           !node_prefetch_is_async(node);
+}
+
+int ngli_node_honor_release_prefetch(struct ngl_ctx *ctx)
+{
+    struct darray *queue = &ctx->prefetch_queue;
+    queue->count = 0;
+
+    struct ngl_node **nodes = ngli_darray_data(&ctx->activitycheck_nodes);
+    for (int i = 0; i < ngli_darray_count(&ctx->activitycheck_nodes); i++) {
         struct ngl_node *node = nodes[i];
 
         if (node->is_active) {
+            if (node_prefetch_is_deferrable(node)) {
+                if (!ngli_darray_push(queue, &node))
+                    return -1;
+                continue;
+            }
             int ret = node_prefetch(node);
             if (ret < 0)
                 return ret;
@@ -470,33 +825,155 @@ int ngli_node_honor_release_prefetch(struct darray *nodes_array)
             node_release(node);
         }
     }
+
+    /*
+     * The nodes are queued children first, which needs to be preserved for
+     * the nodes needed at the same time, so the sort must be stable.
+     */
+    struct ngl_node **queued = ngli_darray_data(queue);
+    const int nb_queued = ngli_darray_count(queue);
+    for (int i = 1; i < nb_queued; i++) {
+        struct ngl_node *node = queued[i];
+        int j = i;
+        for (; j > 0 && queued[j - 1]->next_use_in > node->next_use_in; j--)
+            queued[j] = queued[j - 1];
+        queued[j] = node;
+    }
+
+    return ngli_node_prefetch_deferred(ctx);
+}
+
+/*
+ * Run the queued prefetches, the soonest needed first, until the prefetch
+ * budget of the frame is exhausted. The remaining ones are kept for the next
+ * frame; they are run synchronously anyway as soon as they become needed,
+ * since the visit changing their activity rebuilds the queue.
+ */
+int ngli_node_prefetch_deferred(struct ngl_ctx *ctx)
+{
+    struct darray *queue = &ctx->prefetch_queue;
+    struct ngl_node **queued = ngli_darray_data(queue);
+    const int nb_queued = ngli_darray_count(queue);
+    if (!nb_queued)
+        return 0;
+
+    const int64_t budget = ctx->config.prefetch_budget * 1000000;
+    const int64_t start = ngli_gettime();
+
+    int i = 0;
+    while (i < nb_queued && ngli_gettime() - start < budget) {
+        int ret = node_prefetch(queued[i++]);
+        if (ret < 0)
+            return ret;
+    }
+
+    TRACE("%d/%d deferred prefetches done in %gms", i, nb_queued,
+          (ngli_gettime() - start) / 1000.);
+
+    memmove(queued, queued + i, (nb_queued - i) * sizeof(*queued));
+    queue->count = nb_queued - i;
+
     return 0;
 }
 
+int ngli_node_is_up_to_date(const struct ngl_node *node, double t)
+{
+    if (node->last_update_time == t)
+        return 1;
+
+    /*
+     * A static node only needs to be updated once, unless a live change
+     * happened since then.
+     */
+    return node->is_static && node->last_update_time != -1. &&
+           node->last_update_gen == node->ctx->live_change_gen;
+}
+
+void ngli_node_set_updated(struct ngl_node *node, double t)
+{
+    node->last_update_time = t;
+    node->last_update_gen = node->ctx->live_change_gen;
+    node->draw_count = 0;
+    node->cull_count = 0;
+}
+
 int ngli_node_update(struct ngl_node *node, double t)
 {
     ngli_assert(node->state == STATE_READY);
     if (node->class->update) {
-        if (node->last_update_time != t) {
+        if (!ngli_node_is_up_to_date(node, t)) {
             TRACE("UPDATE %s @ %p with t=%g", node->label, node, t);
+            NGLI_TRACER_BEGIN(node->ctx->tracer, "update", node);
+            struct ngl_memory_stats *prev_owner = ngli_memstats_set_owner(&node->memstats);
             int ret = node->class->update(node, t);
+            ngli_memstats_set_owner(prev_owner);
+            NGLI_TRACER_END(node->ctx->tracer);
             if (ret < 0)
                 return ret;
-            node->last_update_time = t;
-            node->draw_count = 0;
+            ngli_node_set_updated(node, t);
         } else {
-            TRACE("%s already updated for t=%g, skip it", node->label, t);
+            TRACE("%s already up-to-date for t=%g, skip it", node->label, t);
         }
     }
 
     return 0;
 }
 
+struct update_parallel_ctx {
+    struct ngl_node **nodes;
+    double t;
+};
+
+static int update_parallel_job(void *user_arg, int job_id)
+{
+    const struct update_parallel_ctx *s = user_arg;
+    return ngli_node_update(s->nodes[job_id], s->t);
+}
+
+int ngli_node_update_parallel(struct ngl_ctx *ctx, double t)
+{
+    if (!ctx->update_pool)
+        return 0;
+
+    /*
+     * Only the nodes reached during the visit with the time of the frame are
+     * selected: a subtree below a time remapping node (such as a "once" time
+     * range) may be updated at a different time, or not at all, by the serial
+     * update. Nodes updated here are up-to-date when the serial update reaches
+     * them, which is where the GL work (buffer and texture uploads) happens.
+     */
+    struct darray *nodes_array = &ctx->parallel_update_nodes;
+    nodes_array->count = 0;
+
+    struct ngl_node **nodes = ngli_darray_data(&ctx->activitycheck_nodes);
+    for (int i = 0; i < ngli_darray_count(&ctx->activitycheck_nodes); i++) {
+        struct ngl_node *node = nodes[i];
+        if (!(node->class->flags & NODE_FLAG_PARALLEL_UPDATE) ||
+            !node->is_active || node->visit_time_remapped ||
+            node->state != STATE_READY || ngli_node_is_up_to_date(node, t))
+            continue;
+        if (!ngli_darray_push(nodes_array, &node))
+            return -1;
+    }
+
+    const int nb_nodes = ngli_darray_count(nodes_array);
+    if (nb_nodes < 2)
+        return 0;
+
+    struct update_parallel_ctx job_ctx = {
+        .nodes = ngli_darray_data(nodes_array),
+        .t     = t,
+    };
+    return ngli_threadpool_run(ctx->update_pool, update_parallel_job, &job_ctx, nb_nodes);
+}
+
 void ngli_node_draw(struct ngl_node *node)
 {
     if (node->class->draw) {
         TRACE("DRAW %s @ %p", node->label, node);
+        NGLI_TRACER_BEGIN(node->ctx->tracer, "draw", node);
         node->class->draw(node);
+        NGLI_TRACER_END(node->ctx->tracer);
         node->draw_count++;
     }
 }
@@ -516,6 +993,19 @@ const struct node_param *ngli_node_param_find(const struct ngl_node *node, const
     return par;
 }
 
+int ngli_node_live_change(struct ngl_node *node, const struct node_param *par)
+{
+    /*
+     * Static nodes are skipped once updated, and we have no way to reach
+     * the parents of this node, so every static subtree of the scene has
+     * to be updated again.
+     */
+    node->ctx->live_change_gen++;
+    if (par->update_func && node->state != STATE_UNINITIALIZED)
+        return par->update_func(node);
+    return 0;
+}
+
 int ngl_node_param_add(struct ngl_node *node, const char *key,
                        int nb_elems, void *elems)
 {
@@ -537,8 +1027,8 @@ int ngl_node_param_add(struct ngl_node *node, const char *key,
         return ret;
     }
 
-    if (node->ctx && par->update_func)
-        ret = par->update_func(node);
+    if (node->ctx)
+        ret = ngli_node_live_change(node, par);
 
     return ret;
 }
@@ -558,6 +1048,15 @@ int ngl_node_param_set(struct ngl_node *node, const char *key, ...)
         return -1;
     }
 
+    /* The change is applied by the rendering thread once the batch is committed */
+    struct param_batch *batch = node->ctx ? node->ctx->param_batch : NULL;
+    if (batch) {
+        va_start(ap, key);
+        ret = ngli_param_batch_set(batch, node, base_ptr, par, &ap);
+        va_end(ap);
+        return ret;
+    }
+
     va_start(ap, key);
     ret = ngli_params_set(base_ptr, par, &ap);
     va_end(ap);
@@ -566,15 +1065,27 @@ int ngl_node_param_set(struct ngl_node *node, const char *key, ...)
         return ret;
     }
 
-    if (node->ctx && par->update_func)
-        ret = par->update_func(node);
+    if (node->ctx)
+        ret = ngli_node_live_change(node, par);
 
     return ret;
 }
 
+int ngl_node_get_memory_stats(const struct ngl_node *node, struct ngl_memory_stats *stats)
+{
+    /* The statistics are updated atomically so they can be read anytime */
+    ngli_memstats_copy(stats, &node->memstats);
+    return 0;
+}
+
+/*
+ * The graphs can be built from several threads, sharing nodes between them,
+ * so the reference counter is updated atomically. Destroying the node needs
+ * to observe all the changes made by the threads which released it.
+ */
 struct ngl_node *ngl_node_ref(struct ngl_node *node)
 {
-    node->refcount++;
+    __atomic_add_fetch(&node->refcount, 1, __ATOMIC_RELAXED);
     return node;
 }
 
@@ -585,13 +1096,17 @@ void ngl_node_unrefp(struct ngl_node **nodep)
 
     if (!node)
         return;
-    delete = node->refcount-- == 1;
+    delete = __atomic_sub_fetch(&node->refcount, 1, __ATOMIC_ACQ_REL) == 0;
     if (delete) {
         LOG(VERBOSE, "DELETE %s @ %p", node->label, node);
         ngli_assert(!node->ctx);
         ngli_params_free((uint8_t *)node, ngli_base_node_params);
         ngli_params_free(node->priv_data, node->class->params);
-        ngli_free_aligned(node);
+        struct ngl_arena *arena = node->arena;
+        if (arena)
+            ngl_arena_unrefp(&arena);
+        else
+            ngli_free_aligned(node);
     }
     *nodep = NULL;
 }
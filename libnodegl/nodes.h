@@ -46,13 +46,20 @@
 #include "glstate.h"
 #include "hmap.h"
 #include "image.h"
+#include "memstats.h"
 #include "nodegl.h"
 #include "params.h"
+#include "param_batch.h"
 #include "darray.h"
 #include "buffer.h"
 #include "format.h"
 #include "fbo.h"
+#include "plan.h"
+#include "prefetcher.h"
+#include "program.h"
 #include "texture.h"
+#include "threadpool.h"
+#include "tracer.h"
 
 struct node_class;
 
@@ -66,11 +73,23 @@ enum {
 
 typedef int (*cmd_func_type)(struct ngl_ctx *s, void *arg);
 
+struct cmd {
+    cmd_func_type func;
+    void *arg;
+    double t;   /* time of an asynchronous draw */
+    int sync;   /* whether the controller waits for the completion */
+    int ret;
+};
+
+/* Must be a power of 2 */
+#define NGLI_CMD_RING_SIZE 4
+
 struct ngl_ctx {
     /* Controller-only fields */
     const struct backend *backend;
     int configured;
     pthread_t worker_tid;
+    struct param_batch *param_batch; /* batch opened by ngl_param_batch_begin() */
 
     /* Worker-only fields */
     struct glcontext *glcontext;
@@ -81,6 +100,24 @@ struct ngl_ctx {
     struct darray modelview_matrix_stack;
     struct darray projection_matrix_stack;
     struct darray activitycheck_nodes;
+    double activity_start;  /* activity of the nodes does not change */
+    double activity_end;    /* within [activity_start, activity_end) */
+    int activity_gen;
+    int graph_changed;      /* nodes have been initialized during the visit */
+    struct plan plan;
+    struct threadpool *update_pool;
+    struct darray parallel_update_nodes;
+    int visit_time_remap;
+    int visit_lookahead;    /* visiting nodes only active for their future use */
+    double visit_next_use;  /* time until the visited nodes are needed */
+    struct darray prefetch_queue; /* prefetches deferred by the frame budget */
+    struct prefetcher *prefetcher;
+    struct tracer *tracer;
+    struct hmap *reusable_nodes; /* nodes of the previous scene during a hot-swap */
+    struct darray program_builds; /* see ngli_program_build_start() */
+    struct program_cache *program_cache;
+    struct hmap *programs; /* programs shared by the nodes, see ngli_program_get() */
+    struct ngl_sort_stats sort_stats;
 #if defined(HAVE_VAAPI_X11)
     Display *x11_display;
     VADisplay va_display;
@@ -88,12 +125,17 @@ struct ngl_ctx {
 #endif
 
     /* Shared fields */
-    pthread_mutex_t lock;
+    struct cmd cmd_ring[NGLI_CMD_RING_SIZE];
+    unsigned cmd_write_pos; /* only written by the controller */
+    unsigned cmd_read_pos;  /* only written by the worker */
+    pthread_mutex_t lock;   /* only used to sleep when there is nothing to do */
     pthread_cond_t cond_ctl;
     pthread_cond_t cond_wkr;
-    cmd_func_type cmd_func;
-    void *cmd_arg;
-    int cmd_ret;
+    int ctl_sleeping;
+    int wkr_sleeping;
+    int async_ret;
+    int live_change_gen;
+    struct param_batch *committed_batches; /* see ngli_param_batch_commit() */
 };
 
 struct ngl_node {
@@ -102,14 +144,24 @@ struct ngl_node {
 
     int state;
     int is_active;
+    int is_needed;          /* active for the current time, not only ahead of it */
+    int prefetch_pending;   /* prefetch() queued on the context prefetcher */
+    double next_use_in;     /* time until the node is needed, 0 if needed now */
+    struct ngl_memory_stats memstats; /* objects allocated for the node */
 
     double visit_time;
     double last_update_time;
+    int visit_time_remapped;
+
+    int is_static;
+    int last_update_gen;
 
     int draw_count;
+    int cull_count; /* draws skipped by frustum culling, included in draw_count */
 
     int refcount;
     int ctx_refcount;
+    struct ngl_arena *arena; /* arena holding the node, if any */
 
     struct darray children;
 
@@ -157,6 +209,8 @@ struct graphicconfig_priv {
     struct glstate states[2];
 };
 
+void ngli_graphicconfig_honor(struct ngl_node *node, int restore);
+
 struct camera_priv {
     struct ngl_node *child;
     float eye[3];
@@ -193,6 +247,9 @@ struct camera_priv {
     struct texture fbo_color;
 };
 
+int ngli_camera_draw_begin(struct ngl_node *node);
+void ngli_camera_draw_end(struct ngl_node *node);
+
 struct geometry_priv {
     /* quad params */
     float quad_corner[3];
@@ -218,9 +275,13 @@ struct geometry_priv {
     struct ngl_node *indices_buffer;
 
     GLenum topology;
+
+    int has_bbox;       /* only set if the vertices are not animated */
+    float bbox[2][3];   /* min and max corners of the vertices */
 };
 
 struct ngl_node *ngli_node_geometry_generate_buffer(struct ngl_ctx *ctx, int type, int count, int size, void *data);
+void ngli_node_geometry_compute_bbox(struct geometry_priv *s);
 
 struct buffer_priv {
     int count;              // number of elements
@@ -243,6 +304,8 @@ struct buffer_priv {
     struct buffer buffer;
     int buffer_refcount;
     double buffer_last_upload_time;
+
+    struct memstats_entry data_memstats;
 };
 
 int ngli_node_buffer_ref(struct ngl_node *node);
@@ -285,10 +348,7 @@ struct program_priv {
     const char *fragment;
     const char *compute;
 
-    GLuint program_id;
-    struct hmap *active_uniforms;
-    struct hmap *active_attributes;
-    struct hmap *active_buffer_blocks;
+    struct program *program;
 };
 
 struct texture_priv {
@@ -308,6 +368,10 @@ struct uniformprograminfo {
     GLint size;
     GLenum type;
     int binding;
+    int block_index;   /* uniform block of the uniform, -1 if none */
+    int offset;        /* in the uniform block */
+    int array_stride;  /* in the uniform block */
+    int matrix_stride; /* in the uniform block */
 };
 
 struct attributeprograminfo {
@@ -319,6 +383,8 @@ struct attributeprograminfo {
 struct bufferprograminfo {
     GLint binding;
     GLenum type;
+    int block_index;
+    int data_size; /* minimum size of the uniform block data */
 };
 
 #define NGLI_SAMPLING_MODE_NONE         0
@@ -361,6 +427,12 @@ struct pipeline {
     struct hmap *uniforms;
     struct darray uniform_pairs; // nodeprograminfopair (uniform, uniformprograminfo)
 
+    const char *uniforms_block;
+    struct darray block_uniform_pairs; // nodeprograminfopair (uniform, uniformprograminfo)
+    const struct bufferprograminfo *uniforms_block_info;
+    struct buffer uniforms_buffer;
+    uint8_t *uniforms_data; /* CPU copy of the uniforms buffer */
+
     struct hmap *buffers;
     struct darray buffer_pairs; // nodeprograminfopair (buffer, uniformprograminfo)
 };
@@ -375,6 +447,7 @@ struct render_priv {
     struct hmap *instance_attributes;
 
     int nb_instances;
+    int frustum_culling;
 
     struct darray builtin_attribute_pairs; // nodeprograminfopair (builtin attribute, attributeprograminfo)
     struct darray attribute_pairs; // nodeprograminfopair (attribute, attributeprograminfo)
@@ -432,6 +505,35 @@ struct timerangemode_priv {
     int updated;
 };
 
+struct timerangefilter_priv {
+    struct ngl_node *child;
+    struct ngl_node **ranges;
+    int nb_ranges;
+    int current_range;
+    double prefetch_time;
+    double max_idle_time;
+
+    int drawme;
+};
+
+int ngli_timerangefilter_update_state(struct ngl_node *node, double *t);
+
+struct group_priv {
+    struct ngl_node **children;
+    int nb_children;
+    int sort;
+    int instancing;
+
+    struct ngl_node **draw_children; /* children in their draw order */
+    int state_changes[2];            /* see ngl_sort_stats */
+    struct darray batches;           /* instancing batches of consecutive draw_children */
+};
+
+struct userswitch_priv {
+    struct ngl_node *child;
+    int enabled;
+};
+
 struct transform_priv {
     struct ngl_node *child;
     NGLI_ALIGNED_MAT(matrix);
@@ -592,9 +694,44 @@ struct hud_priv {
  * Note: nodes implementation do NOT have to implement this logic, but they can
  * rely on these properties in their callback implementations.
  */
+
+/*
+ * The node output changes with time even if its parameters are constant.
+ * Nodes without this flag and with only static children are considered
+ * static: their update() is skipped once they have been updated, until a
+ * live parameter change happens.
+ */
+#define NODE_FLAG_TIME_DEPENDENT (1 << 0)
+
+/*
+ * The node update() is pure CPU work: it does not make any GL call and does
+ * not update any other node. If the context has an update thread pool, such
+ * nodes are updated concurrently before the (serial) update of the scene.
+ */
+#define NODE_FLAG_PARALLEL_UPDATE (1 << 1)
+
+/*
+ * The node prefetch() only creates shareable GL objects (textures, buffers,
+ * ...) or no GL object at all, and does not access any other node being
+ * updated concurrently. If the context has a prefetch thread, nodes only
+ * active ahead of their use are prefetched from that thread.
+ */
+#define NODE_FLAG_ASYNC_PREFETCH (1 << 2)
+
+/*
+ * The state of the node only depends on its parameters, which do not
+ * reference any other node, and no other node keeps a pointer to its private
+ * data. If hot-swap is enabled, the state of an initialized node of the
+ * previous scene is transplanted into an identical node of the new one
+ * instead of initializing it.
+ */
+#define NODE_FLAG_REUSABLE (1 << 3)
+
 struct node_class {
     int id;
     const char *name;
+    int flags;
+    int (*pre_init)(struct ngl_node *node);
     int (*init)(struct ngl_node *node);
     int (*visit)(struct ngl_node *node, int is_active, double t);
     int (*prefetch)(struct ngl_node *node);
@@ -612,18 +749,36 @@ struct node_class {
 void ngli_node_print_specs(void);
 
 int ngli_node_visit(struct ngl_node *node, int is_active, double t);
-int ngli_node_honor_release_prefetch(struct darray *nodes_array);
+int ngli_node_honor_release_prefetch(struct ngl_ctx *ctx);
+int ngli_node_prefetch_deferred(struct ngl_ctx *ctx);
 int ngli_node_update(struct ngl_node *node, double t);
+int ngli_node_update_parallel(struct ngl_ctx *ctx, double t);
+int ngli_node_is_up_to_date(const struct ngl_node *node, double t);
+void ngli_node_set_updated(struct ngl_node *node, double t);
 int ngli_prepare_draw(struct ngl_ctx *s, double t);
 void ngli_node_draw(struct ngl_node *node);
 
 int ngli_node_attach_ctx(struct ngl_node *node, struct ngl_ctx *ctx);
+/* Defers the init of the nodes to their first active visit (not for internal nodes) */
+int ngli_node_attach_ctx_lazy(struct ngl_node *node, struct ngl_ctx *ctx);
 void ngli_node_detach_ctx(struct ngl_node *node);
 
+/*
+ * Between these calls, the reusable nodes detached from the context are kept
+ * initialized so the identical nodes attached to it can take over their state
+ * instead of being initialized. The nodes which have not been reused are
+ * uninitialized by ngli_node_reusable_reset().
+ */
+int ngli_node_reusable_init(struct ngl_ctx *ctx);
+void ngli_node_reusable_reset(struct ngl_ctx *ctx);
+
 char *ngli_node_default_label(const char *class_name);
 int ngli_is_default_label(const char *class_name, const char *str);
-struct ngl_node *ngli_node_create_noconstructor(int type);
+struct ngl_node *ngli_node_create_noconstructor(struct ngl_arena *arena, int type);
 const struct node_param *ngli_node_param_find(const struct ngl_node *node, const char *key,
                                               uint8_t **base_ptrp);
 
+/* Account for a live change of the parameter par of an attached node */
+int ngli_node_live_change(struct ngl_node *node, const struct node_param *par);
+
 #endif
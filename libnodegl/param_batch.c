@@ -0,0 +1,181 @@
+/*
+ * Copyright 2018 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#include <string.h>
+
+#include "darray.h"
+#include "log.h"
+#include "memory.h"
+#include "nodes.h"
+#include "param_batch.h"
+#include "utils.h"
+
+extern const struct param_specs ngli_params_specs[];
+
+struct param_change {
+    struct ngl_node *node;
+    uint8_t *base_ptr;
+    const struct node_param *par;
+    union {
+        float mat[4*4];
+        int64_t i64;
+        double dbl;
+        void *p;
+    } value; /* parameter value, as stored in the node */
+};
+
+struct param_batch {
+    struct darray changes;
+    struct param_batch *next;
+};
+
+struct param_batch *ngli_param_batch_create(void)
+{
+    struct param_batch *s = ngli_calloc(1, sizeof(*s));
+    if (!s)
+        return NULL;
+    ngli_darray_init(&s->changes, sizeof(struct param_change), 0);
+    return s;
+}
+
+int ngli_param_batch_set(struct param_batch *s, struct ngl_node *node,
+                         uint8_t *base_ptr, const struct node_param *par, va_list *ap)
+{
+    if (par->type == PARAM_TYPE_NODEDICT) {
+        LOG(ERROR, "%s.%s can not be changed in a batch", node->label, par->key);
+        return -1;
+    }
+    ngli_assert(ngli_params_specs[par->type].size <= sizeof(((struct param_change *)0)->value));
+
+    struct param_change *change = ngli_darray_push(&s->changes, NULL);
+    if (!change)
+        return -1;
+    memset(change, 0, sizeof(*change));
+    change->node = ngl_node_ref(node);
+    change->base_ptr = base_ptr;
+    change->par = par;
+
+    /* The value is stored at the beginning of the change value */
+    struct node_param value_par = *par;
+    value_par.offset = 0;
+    int ret = ngli_params_set((uint8_t *)&change->value, &value_par, ap);
+    if (ret < 0) {
+        LOG(ERROR, "unable to set %s.%s", node->label, par->key);
+        ngl_node_unrefp(&change->node);
+        ngli_darray_pop(&s->changes);
+        return ret;
+    }
+
+    return 0;
+}
+
+static void free_change(struct param_change *change)
+{
+    const struct node_param value_params[] = {
+        {.key=change->par->key, .type=change->par->type},
+        {NULL},
+    };
+    ngli_params_free((uint8_t *)&change->value, value_params);
+    ngl_node_unrefp(&change->node);
+}
+
+static int apply_change(struct param_change *change)
+{
+    struct ngl_node *node = change->node;
+    const struct node_param *par = change->par;
+    uint8_t *dstp = change->base_ptr + par->offset;
+    const size_t size = ngli_params_specs[par->type].size;
+
+    /* The previous value is moved to the change so it is freed with it */
+    uint8_t prev_value[sizeof(change->value)];
+    memcpy(prev_value, dstp, size);
+    memcpy(dstp, &change->value, size);
+    memcpy(&change->value, prev_value, size);
+
+    return ngli_node_live_change(node, par);
+}
+
+void ngli_param_batch_commit(struct param_batch **committed, struct param_batch *s)
+{
+    s->next = __atomic_load_n(committed, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(committed, &s->next, s, 1,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+        ;
+}
+
+/*
+ * Detach the list of committed batches, which is stacked from the last
+ * commit, and return it in the commit order.
+ */
+static struct param_batch *take_committed(struct param_batch **committed)
+{
+    struct param_batch *s = __atomic_exchange_n(committed, NULL, __ATOMIC_ACQUIRE);
+    struct param_batch *ordered = NULL;
+    while (s) {
+        struct param_batch *next = s->next;
+        s->next = ordered;
+        ordered = s;
+        s = next;
+    }
+    return ordered;
+}
+
+int ngli_param_batch_apply_committed(struct param_batch **committed)
+{
+    int ret = 0;
+    struct param_batch *s = take_committed(committed);
+    while (s) {
+        struct param_batch *next = s->next;
+        struct param_change *changes = ngli_darray_data(&s->changes);
+        for (int i = 0; i < ngli_darray_count(&s->changes); i++) {
+            int change_ret = apply_change(&changes[i]);
+            if (change_ret < 0 && ret >= 0)
+                ret = change_ret;
+        }
+        ngli_param_batch_freep(&s);
+        s = next;
+    }
+    return ret;
+}
+
+void ngli_param_batch_free_committed(struct param_batch **committed)
+{
+    struct param_batch *s = take_committed(committed);
+    while (s) {
+        struct param_batch *next = s->next;
+        ngli_param_batch_freep(&s);
+        s = next;
+    }
+}
+
+void ngli_param_batch_freep(struct param_batch **sp)
+{
+    struct param_batch *s = *sp;
+    if (!s)
+        return;
+    struct param_change *changes = ngli_darray_data(&s->changes);
+    for (int i = 0; i < ngli_darray_count(&s->changes); i++)
+        free_change(&changes[i]);
+    ngli_darray_reset(&s->changes);
+    ngli_free(s);
+    *sp = NULL;
+}
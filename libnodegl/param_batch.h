@@ -0,0 +1,61 @@
+/*
+ * Copyright 2018 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#ifndef PARAM_BATCH_H
+#define PARAM_BATCH_H
+
+#include <stdarg.h>
+#include <stdint.h>
+
+#include "params.h"
+
+struct ngl_node;
+struct param_batch;
+
+struct param_batch *ngli_param_batch_create(void);
+
+/*
+ * Queue the change of a parameter of a node attached to a context, the value
+ * being read from the arguments as with ngli_params_set(). The node is
+ * referenced until the batch is freed. A batch must only be filled from a
+ * single thread.
+ */
+int ngli_param_batch_set(struct param_batch *s, struct ngl_node *node,
+                         uint8_t *base_ptr, const struct node_param *par, va_list *ap);
+
+/*
+ * Publish a batch to the rendering thread. This is lock-free and can be done
+ * while the rendering thread is applying the previously committed batches.
+ */
+void ngli_param_batch_commit(struct param_batch **committed, struct param_batch *s);
+
+/*
+ * Apply all the batches committed so far in their commit order, and free
+ * them. Every change is applied even if a previous one failed, the first
+ * error being returned.
+ */
+int ngli_param_batch_apply_committed(struct param_batch **committed);
+
+void ngli_param_batch_free_committed(struct param_batch **committed);
+void ngli_param_batch_freep(struct param_batch **sp);
+
+#endif
@@ -698,3 +698,115 @@ void ngli_params_free(uint8_t *base_ptr, const struct node_param *params)
         }
     }
 }
+
+/*
+ * Get the memory holding the value of a parameter, following the pointers of
+ * the types stored out of the node private data. Nodes are referenced by
+ * their address, and dictionaries are handled separately.
+ */
+static const void *get_param_value(const uint8_t *base_ptr, const struct node_param *par, size_t *size)
+{
+    const uint8_t *parp = base_ptr + par->offset;
+
+    switch (par->type) {
+        case PARAM_TYPE_STR: {
+            const char *s = *(const char **)parp;
+            *size = s ? strlen(s) + 1 : 0;
+            return s;
+        }
+        case PARAM_TYPE_DATA:
+            *size = *(const int *)(parp + sizeof(void *));
+            return *(const void **)parp;
+        case PARAM_TYPE_NODELIST:
+            *size = *(const int *)(parp + sizeof(struct ngl_node **)) * sizeof(struct ngl_node *);
+            return *(const void **)parp;
+        case PARAM_TYPE_DBLLIST:
+            *size = *(const int *)(parp + sizeof(double *)) * sizeof(double);
+            return *(const void **)parp;
+        default:
+            *size = ngli_params_specs[par->type].size;
+            return parp;
+    }
+}
+
+#define FNV1A_INIT 0x811c9dc5
+
+static uint32_t fnv1a(uint32_t hash, const void *data, size_t size)
+{
+    const uint8_t *p = data;
+    for (size_t i = 0; i < size; i++)
+        hash = (hash ^ p[i]) * 0x01000193;
+    return hash;
+}
+
+uint32_t ngli_params_hash(const uint8_t *base_ptr, const struct node_param *params)
+{
+    uint32_t hash = FNV1A_INIT;
+
+    if (!params)
+        return hash;
+
+    for (int i = 0; params[i].key; i++) {
+        const struct node_param *par = &params[i];
+
+        if (par->type == PARAM_TYPE_NODEDICT) {
+            /* Order independent, the entries order depends on the insertions */
+            const struct hmap *hmap = *(struct hmap **)(base_ptr + par->offset);
+            const struct hmap_entry *entry = NULL;
+            uint32_t entries_hash = 0;
+            while (hmap && (entry = ngli_hmap_next(hmap, entry))) {
+                uint32_t entry_hash = fnv1a(FNV1A_INIT, entry->key, strlen(entry->key));
+                entries_hash ^= fnv1a(entry_hash, &entry->data, sizeof(entry->data));
+            }
+            hash = fnv1a(hash, &entries_hash, sizeof(entries_hash));
+            continue;
+        }
+
+        size_t size;
+        const void *value = get_param_value(base_ptr, par, &size);
+        hash = fnv1a(hash, &size, sizeof(size));
+        if (value)
+            hash = fnv1a(hash, value, size);
+    }
+
+    return hash;
+}
+
+static int nodedict_equal(const struct hmap *a, const struct hmap *b)
+{
+    const int count = a ? ngli_hmap_count((struct hmap *)a) : 0;
+    if (count != (b ? ngli_hmap_count((struct hmap *)b) : 0))
+        return 0;
+
+    const struct hmap_entry *entry = NULL;
+    while (count && (entry = ngli_hmap_next(a, entry)))
+        if (ngli_hmap_get(b, entry->key) != entry->data)
+            return 0;
+    return 1;
+}
+
+int ngli_params_equal(const uint8_t *base_ptr_a, const uint8_t *base_ptr_b,
+                      const struct node_param *params)
+{
+    if (!params)
+        return 1;
+
+    for (int i = 0; params[i].key; i++) {
+        const struct node_param *par = &params[i];
+
+        if (par->type == PARAM_TYPE_NODEDICT) {
+            if (!nodedict_equal(*(struct hmap **)(base_ptr_a + par->offset),
+                                *(struct hmap **)(base_ptr_b + par->offset)))
+                return 0;
+            continue;
+        }
+
+        size_t size_a, size_b;
+        const void *value_a = get_param_value(base_ptr_a, par, &size_a);
+        const void *value_b = get_param_value(base_ptr_b, par, &size_b);
+        if (size_a != size_b || (size_a && memcmp(value_a, value_b, size_a)))
+            return 0;
+    }
+
+    return 1;
+}
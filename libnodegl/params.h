@@ -68,6 +68,7 @@ struct param_choices {
 #define PARAM_FLAG_DOT_DISPLAY_PACKED (1<<1)
 #define PARAM_FLAG_DOT_DISPLAY_FIELDNAME (1<<2)
 #define PARAM_FLAG_ALLOW_LIVE_CHANGE (1<<3)
+#define PARAM_FLAG_LAZY_INIT (1<<4) /* node is only initialized on its first active visit */
 struct node_param {
     const char *key;
     int type;
@@ -100,5 +101,8 @@ int ngli_params_set_constructors(uint8_t *base_ptr, const struct node_param *par
 int ngli_params_set_defaults(uint8_t *base_ptr, const struct node_param *params);
 int ngli_params_add(uint8_t *base_ptr, const struct node_param *par, int nb_elems, void *elems);
 void ngli_params_free(uint8_t *base_ptr, const struct node_param *params);
+uint32_t ngli_params_hash(const uint8_t *base_ptr, const struct node_param *params);
+int ngli_params_equal(const uint8_t *base_ptr_a, const uint8_t *base_ptr_b,
+                      const struct node_param *params);
 
 #endif
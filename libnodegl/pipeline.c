@@ -33,6 +33,7 @@
 #include "memory.h"
 #include "nodegl.h"
 #include "nodes.h"
+#include "program.h"
 #include "texture.h"
 #include "utils.h"
 
@@ -96,7 +97,14 @@ static int get_disabled_texture_unit(const struct glcontext *gl,
     return tex_unit;
 }
 
-static int bind_texture_plane(const struct glcontext *gl,
+static struct program *get_program(const struct pipeline *s)
+{
+    const struct program_priv *program = s->program->priv_data;
+    return program->program;
+}
+
+static int bind_texture_plane(struct glcontext *gl,
+                              struct program *program,
                               const struct texture *plane,
                               uint64_t *used_texture_units,
                               int location)
@@ -106,17 +114,18 @@ static int bind_texture_plane(const struct glcontext *gl,
         return -1;
     ngli_glActiveTexture(gl, GL_TEXTURE0 + texture_index);
     ngli_glBindTexture(gl, plane->target, plane->id);
-    ngli_glUniform1i(gl, location, texture_index);
+    ngli_program_upload_uniform(gl, program, location, GL_INT, 1, &texture_index);
     return 0;
 }
 
-static int update_sampler(const struct glcontext *gl,
+static int update_sampler(struct glcontext *gl,
                           struct pipeline *s,
                           const struct image *image,
                           const struct textureprograminfo *info,
                           uint64_t *used_texture_units,
                           int *sampling_mode)
 {
+    struct program *program = get_program(s);
     struct {
         int id;
         int type_index;
@@ -137,7 +146,7 @@ static int update_sampler(const struct glcontext *gl,
                 GLuint unit = info->sampler_value;
                 ngli_glBindImageTexture(gl, unit, plane->id, 0, GL_FALSE, 0, params->access, plane->internal_format);
             } else {
-                int ret = bind_texture_plane(gl, plane, used_texture_units, info->sampler_location);
+                int ret = bind_texture_plane(gl, program, plane, used_texture_units, info->sampler_location);
                 if (ret < 0)
                     return ret;
                 *sampling_mode = NGLI_SAMPLING_MODE_DEFAULT;
@@ -147,7 +156,7 @@ static int update_sampler(const struct glcontext *gl,
     } else if (image->layout == NGLI_IMAGE_LAYOUT_NV12) {
         if (info->y_sampler_location >= 0) {
             const struct texture *plane = image->planes[0];
-            int ret = bind_texture_plane(gl, plane, used_texture_units, info->y_sampler_location);
+            int ret = bind_texture_plane(gl, program, plane, used_texture_units, info->y_sampler_location);
             if (ret < 0)
                 return ret;
             samplers[1].bound = 1;
@@ -155,7 +164,7 @@ static int update_sampler(const struct glcontext *gl,
         }
         if (info->uv_sampler_location >= 0) {
             const struct texture *plane = image->planes[1];
-            int ret = bind_texture_plane(gl, plane, used_texture_units, info->uv_sampler_location);
+            int ret = bind_texture_plane(gl, program, plane, used_texture_units, info->uv_sampler_location);
             if (ret < 0)
                 return ret;
             samplers[2].bound = 1;
@@ -164,7 +173,7 @@ static int update_sampler(const struct glcontext *gl,
     } else if (image->layout == NGLI_IMAGE_LAYOUT_MEDIACODEC) {
         if (info->external_sampler_location >= 0) {
             const struct texture *plane = image->planes[0];
-            int ret = bind_texture_plane(gl, plane, used_texture_units, info->external_sampler_location);
+            int ret = bind_texture_plane(gl, program, plane, used_texture_units, info->external_sampler_location);
             if (ret < 0)
                 return ret;
             samplers[3].bound = 1;
@@ -180,7 +189,7 @@ static int update_sampler(const struct glcontext *gl,
         int disabled_texture_unit = get_disabled_texture_unit(gl, s, used_texture_units, samplers[i].type_index);
         if (disabled_texture_unit < 0)
             return -1;
-        ngli_glUniform1i(gl, samplers[i].id, disabled_texture_unit);
+        ngli_program_upload_uniform(gl, program, samplers[i].id, GL_INT, 1, &disabled_texture_unit);
     }
 
     return 0;
@@ -191,6 +200,7 @@ static int update_images_and_samplers(struct ngl_node *node)
     struct ngl_ctx *ctx = node->ctx;
     struct glcontext *gl = ctx->glcontext;
     struct pipeline *s = get_pipeline(node);
+    struct program *program = get_program(s);
 
     if (s->textures) {
         uint64_t used_texture_units = s->used_texture_units;
@@ -212,10 +222,12 @@ static int update_images_and_samplers(struct ngl_node *node)
                 return ret;
 
             if (info->sampling_mode_location >= 0)
-                ngli_glUniform1i(gl, info->sampling_mode_location, sampling_mode);
+                ngli_program_upload_uniform(gl, program, info->sampling_mode_location,
+                                            GL_INT, 1, &sampling_mode);
 
             if (info->coord_matrix_location >= 0)
-                ngli_glUniformMatrix4fv(gl, info->coord_matrix_location, 1, GL_FALSE, image->coordinates_matrix);
+                ngli_program_upload_uniform(gl, program, info->coord_matrix_location,
+                                            GL_FLOAT_MAT4, 1, image->coordinates_matrix);
 
             if (info->dimensions_location >= 0) {
                 float dimensions[3] = {0};
@@ -225,14 +237,14 @@ static int update_images_and_samplers(struct ngl_node *node)
                     dimensions[1] = params->height;
                     dimensions[2] = params->depth;
                 }
-                if (info->dimensions_type == GL_FLOAT_VEC2)
-                    ngli_glUniform2fv(gl, info->dimensions_location, 1, dimensions);
-                else if (info->dimensions_type == GL_FLOAT_VEC3)
-                    ngli_glUniform3fv(gl, info->dimensions_location, 1, dimensions);
+                ngli_program_upload_uniform(gl, program, info->dimensions_location,
+                                            info->dimensions_type, 1, dimensions);
             }
 
-            if (info->ts_location >= 0)
-                ngli_glUniform1f(gl, info->ts_location, image->ts);
+            if (info->ts_location >= 0) {
+                const float ts = image->ts;
+                ngli_program_upload_uniform(gl, program, info->ts_location, GL_FLOAT, 1, &ts);
+            }
         }
     }
 
@@ -244,6 +256,7 @@ static int update_uniforms(struct ngl_node *node)
     struct ngl_ctx *ctx = node->ctx;
     struct glcontext *gl = ctx->glcontext;
     struct pipeline *s = get_pipeline(node);
+    struct program *program = get_program(s);
 
     const struct darray *uniform_pairs = &s->uniform_pairs;
     const struct nodeprograminfopair *pairs = ngli_darray_data(uniform_pairs);
@@ -257,35 +270,36 @@ static int update_uniforms(struct ngl_node *node)
         switch (unode->class->id) {
         case NGL_NODE_UNIFORMFLOAT: {
             const struct uniform_priv *u = unode->priv_data;
-            ngli_glUniform1f(gl, uid, u->scalar);
+            const float scalar = u->scalar;
+            ngli_program_upload_uniform(gl, program, uid, GL_FLOAT, 1, &scalar);
             break;
         }
         case NGL_NODE_UNIFORMVEC2: {
             const struct uniform_priv *u = unode->priv_data;
-            ngli_glUniform2fv(gl, uid, 1, u->vector);
+            ngli_program_upload_uniform(gl, program, uid, GL_FLOAT_VEC2, 1, u->vector);
             break;
         }
         case NGL_NODE_UNIFORMVEC3: {
             const struct uniform_priv *u = unode->priv_data;
-            ngli_glUniform3fv(gl, uid, 1, u->vector);
+            ngli_program_upload_uniform(gl, program, uid, GL_FLOAT_VEC3, 1, u->vector);
             break;
         }
         case NGL_NODE_UNIFORMVEC4: {
             const struct uniform_priv *u = unode->priv_data;
-            ngli_glUniform4fv(gl, uid, 1, u->vector);
+            ngli_program_upload_uniform(gl, program, uid, GL_FLOAT_VEC4, 1, u->vector);
             break;
         }
         case NGL_NODE_UNIFORMINT: {
             const struct uniform_priv *u = unode->priv_data;
-            ngli_glUniform1i(gl, uid, u->ival);
+            ngli_program_upload_uniform(gl, program, uid, GL_INT, 1, &u->ival);
             break;
         }
         case NGL_NODE_UNIFORMQUAT: {
             const struct uniform_priv *u = unode->priv_data;
             if (info->type == GL_FLOAT_MAT4)
-                ngli_glUniformMatrix4fv(gl, uid, 1, GL_FALSE, u->matrix);
+                ngli_program_upload_uniform(gl, program, uid, GL_FLOAT_MAT4, 1, u->matrix);
             else if (info->type == GL_FLOAT_VEC4)
-                ngli_glUniform4fv(gl, uid, 1, u->vector);
+                ngli_program_upload_uniform(gl, program, uid, GL_FLOAT_VEC4, 1, u->vector);
             else
                 LOG(ERROR,
                     "quaternion uniform '%s' must be declared as vec4 or mat4 in the shader",
@@ -294,27 +308,27 @@ static int update_uniforms(struct ngl_node *node)
         }
         case NGL_NODE_UNIFORMMAT4: {
             const struct uniform_priv *u = unode->priv_data;
-            ngli_glUniformMatrix4fv(gl, uid, 1, GL_FALSE, u->matrix);
+            ngli_program_upload_uniform(gl, program, uid, GL_FLOAT_MAT4, 1, u->matrix);
             break;
         }
         case NGL_NODE_BUFFERFLOAT: {
             const struct buffer_priv *buffer = unode->priv_data;
-            ngli_glUniform1fv(gl, uid, buffer->count, (const GLfloat *)buffer->data);
+            ngli_program_upload_uniform(gl, program, uid, GL_FLOAT, buffer->count, buffer->data);
             break;
         }
         case NGL_NODE_BUFFERVEC2: {
             const struct buffer_priv *buffer = unode->priv_data;
-            ngli_glUniform2fv(gl, uid, buffer->count, (const GLfloat *)buffer->data);
+            ngli_program_upload_uniform(gl, program, uid, GL_FLOAT_VEC2, buffer->count, buffer->data);
             break;
         }
         case NGL_NODE_BUFFERVEC3: {
             const struct buffer_priv *buffer = unode->priv_data;
-            ngli_glUniform3fv(gl, uid, buffer->count, (const GLfloat *)buffer->data);
+            ngli_program_upload_uniform(gl, program, uid, GL_FLOAT_VEC3, buffer->count, buffer->data);
             break;
         }
         case NGL_NODE_BUFFERVEC4: {
             const struct buffer_priv *buffer = unode->priv_data;
-            ngli_glUniform4fv(gl, uid, buffer->count, (const GLfloat *)buffer->data);
+            ngli_program_upload_uniform(gl, program, uid, GL_FLOAT_VEC4, buffer->count, buffer->data);
             break;
         }
         default:
@@ -326,6 +340,110 @@ static int update_uniforms(struct ngl_node *node)
     return 0;
 }
 
+static void write_block_data(struct pipeline *s, int offset, const void *data, int size,
+                             int *dirty_start, int *dirty_end)
+{
+    uint8_t *dst = s->uniforms_data + offset;
+    if (!memcmp(dst, data, size))
+        return;
+    memcpy(dst, data, size);
+    *dirty_start = NGLI_MIN(*dirty_start, offset);
+    *dirty_end   = NGLI_MAX(*dirty_end, offset + size);
+}
+
+static void write_block_matrix(struct pipeline *s, const struct uniformprograminfo *info,
+                               const float *matrix, int *dirty_start, int *dirty_end)
+{
+    for (int i = 0; i < 4; i++)
+        write_block_data(s, info->offset + i * info->matrix_stride, matrix + i * 4,
+                         4 * sizeof(*matrix), dirty_start, dirty_end);
+}
+
+/*
+ * Pack the values of the uniforms into the CPU copy of the uniforms block
+ * and only upload the ranges which changed.
+ */
+static int update_uniforms_block(struct ngl_node *node)
+{
+    struct ngl_ctx *ctx = node->ctx;
+    struct glcontext *gl = ctx->glcontext;
+    struct pipeline *s = get_pipeline(node);
+
+    if (!s->uniforms_block_info)
+        return 0;
+
+    int dirty_start = INT_MAX;
+    int dirty_end = 0;
+
+    const struct darray *block_uniform_pairs = &s->block_uniform_pairs;
+    const struct nodeprograminfopair *pairs = ngli_darray_data(block_uniform_pairs);
+    for (int i = 0; i < ngli_darray_count(block_uniform_pairs); i++) {
+        const struct nodeprograminfopair *pair = &pairs[i];
+        const struct uniformprograminfo *info = pair->program_info;
+        const struct ngl_node *unode = pair->node;
+        switch (unode->class->id) {
+        case NGL_NODE_UNIFORMFLOAT: {
+            const struct uniform_priv *u = unode->priv_data;
+            const float scalar = u->scalar;
+            write_block_data(s, info->offset, &scalar, sizeof(scalar), &dirty_start, &dirty_end);
+            break;
+        }
+        case NGL_NODE_UNIFORMVEC2:
+        case NGL_NODE_UNIFORMVEC3:
+        case NGL_NODE_UNIFORMVEC4: {
+            const struct uniform_priv *u = unode->priv_data;
+            const int nb_comp = unode->class->id == NGL_NODE_UNIFORMVEC2 ? 2
+                              : unode->class->id == NGL_NODE_UNIFORMVEC3 ? 3 : 4;
+            write_block_data(s, info->offset, u->vector, nb_comp * sizeof(*u->vector), &dirty_start, &dirty_end);
+            break;
+        }
+        case NGL_NODE_UNIFORMINT: {
+            const struct uniform_priv *u = unode->priv_data;
+            write_block_data(s, info->offset, &u->ival, sizeof(u->ival), &dirty_start, &dirty_end);
+            break;
+        }
+        case NGL_NODE_UNIFORMQUAT: {
+            const struct uniform_priv *u = unode->priv_data;
+            if (info->type == GL_FLOAT_MAT4)
+                write_block_matrix(s, info, u->matrix, &dirty_start, &dirty_end);
+            else
+                write_block_data(s, info->offset, u->vector, sizeof(u->vector), &dirty_start, &dirty_end);
+            break;
+        }
+        case NGL_NODE_UNIFORMMAT4: {
+            const struct uniform_priv *u = unode->priv_data;
+            write_block_matrix(s, info, u->matrix, &dirty_start, &dirty_end);
+            break;
+        }
+        case NGL_NODE_BUFFERFLOAT:
+        case NGL_NODE_BUFFERVEC2:
+        case NGL_NODE_BUFFERVEC3:
+        case NGL_NODE_BUFFERVEC4: {
+            const struct buffer_priv *buffer = unode->priv_data;
+            const int count = NGLI_MIN(buffer->count, info->size);
+            const int elem_size = buffer->data_comp * sizeof(float);
+            for (int j = 0; j < count; j++)
+                write_block_data(s, info->offset + j * info->array_stride,
+                                 buffer->data + j * buffer->data_stride, elem_size,
+                                 &dirty_start, &dirty_end);
+            break;
+        }
+        default:
+            ngli_assert(0);
+        }
+    }
+
+    const GLuint id = s->uniforms_buffer.id;
+    if (dirty_start < dirty_end) {
+        ngli_glBindBuffer(gl, GL_UNIFORM_BUFFER, id);
+        ngli_glBufferSubData(gl, GL_UNIFORM_BUFFER, dirty_start, dirty_end - dirty_start,
+                             s->uniforms_data + dirty_start);
+    }
+    ngli_glBindBufferBase(gl, GL_UNIFORM_BUFFER, s->uniforms_block_info->binding, id);
+
+    return 0;
+}
+
 static int update_buffers(struct ngl_node *node)
 {
     struct ngl_ctx *ctx = node->ctx;
@@ -374,6 +492,82 @@ static const struct texture_uniform_map {
     {"_uv_sampler",       (const GLenum[]){GL_SAMPLER_2D, 0},                             OFFSET(uv_sampler_location),       SIZE_MAX,                SIZE_MAX},
 };
 
+static const struct {
+    int node_id;
+    GLenum types[3];
+} block_uniform_types[] = {
+    {NGL_NODE_UNIFORMFLOAT, {GL_FLOAT}},
+    {NGL_NODE_UNIFORMVEC2,  {GL_FLOAT_VEC2}},
+    {NGL_NODE_UNIFORMVEC3,  {GL_FLOAT_VEC3}},
+    {NGL_NODE_UNIFORMVEC4,  {GL_FLOAT_VEC4}},
+    {NGL_NODE_UNIFORMINT,   {GL_INT}},
+    {NGL_NODE_UNIFORMQUAT,  {GL_FLOAT_VEC4, GL_FLOAT_MAT4}},
+    {NGL_NODE_UNIFORMMAT4,  {GL_FLOAT_MAT4}},
+    {NGL_NODE_BUFFERFLOAT,  {GL_FLOAT}},
+    {NGL_NODE_BUFFERVEC2,   {GL_FLOAT_VEC2}},
+    {NGL_NODE_BUFFERVEC3,   {GL_FLOAT_VEC3}},
+    {NGL_NODE_BUFFERVEC4,   {GL_FLOAT_VEC4}},
+};
+
+/*
+ * The uniforms are written in the block as is so their types must match
+ * exactly the ones of the block members.
+ */
+static int check_block_uniform_type(const struct ngl_node *unode, const struct uniformprograminfo *info)
+{
+    for (int i = 0; i < NGLI_ARRAY_NB(block_uniform_types); i++) {
+        if (block_uniform_types[i].node_id != unode->class->id)
+            continue;
+        for (int j = 0; j < NGLI_ARRAY_NB(block_uniform_types[i].types); j++)
+            if (block_uniform_types[i].types[j] == info->type)
+                return 0;
+        break;
+    }
+    return -1;
+}
+
+static int init_uniforms_block(struct ngl_node *node)
+{
+    struct ngl_ctx *ctx = node->ctx;
+    struct glcontext *gl = ctx->glcontext;
+    struct pipeline *s = get_pipeline(node);
+    const struct program_priv *program_priv = s->program->priv_data;
+    const struct program *program = program_priv->program;
+
+    if (!(gl->features & NGLI_FEATURE_UNIFORM_BUFFER_OBJECT)) {
+        LOG(ERROR, "context does not support uniform blocks, "
+            "uniforms_block of %s can not be used", node->label);
+        return -1;
+    }
+
+    const struct bufferprograminfo *info = ngli_hmap_get(program->active_buffer_blocks, s->uniforms_block);
+    if (!info || info->type != GL_UNIFORM_BUFFER) {
+        LOG(ERROR, "uniform block %s of %s not found in %s",
+            s->uniforms_block, node->label, s->program->label);
+        return -1;
+    }
+
+    if (info->data_size > gl->max_uniform_block_size) {
+        LOG(ERROR, "uniform block %s size (%d) exceeds max uniform block size (%d)",
+            s->uniforms_block, info->data_size, gl->max_uniform_block_size);
+        return -1;
+    }
+
+    s->uniforms_data = ngli_calloc(1, info->data_size);
+    if (!s->uniforms_data)
+        return -1;
+
+    int ret = ngli_buffer_allocate(&s->uniforms_buffer, gl, info->data_size, GL_DYNAMIC_DRAW);
+    if (ret < 0)
+        return ret;
+    ret = ngli_buffer_upload(&s->uniforms_buffer, s->uniforms_data, info->data_size);
+    if (ret < 0)
+        return ret;
+
+    s->uniforms_block_info = info;
+    return 0;
+}
+
 static int is_allowed_type(const GLenum *allowed_types, GLenum type)
 {
     for (int i = 0; allowed_types[i]; i++)
@@ -417,29 +611,56 @@ int ngli_pipeline_init(struct ngl_node *node)
     struct ngl_ctx *ctx = node->ctx;
     struct glcontext *gl = ctx->glcontext;
     struct pipeline *s = get_pipeline(node);
-    struct program_priv *program = s->program->priv_data;
+    struct program_priv *program_priv = s->program->priv_data;
+    const struct program *program = program_priv->program;
 
     ngli_darray_init(&s->texture_pairs, sizeof(struct nodeprograminfopair), 0);
     ngli_darray_init(&s->uniform_pairs, sizeof(struct nodeprograminfopair), 0);
+    ngli_darray_init(&s->block_uniform_pairs, sizeof(struct nodeprograminfopair), 0);
     ngli_darray_init(&s->buffer_pairs, sizeof(struct nodeprograminfopair), 0);
 
+    if (s->uniforms_block) {
+        int ret = init_uniforms_block(node);
+        if (ret < 0)
+            return ret;
+    }
+
     if (s->uniforms) {
         const struct hmap_entry *entry = NULL;
         while ((entry = ngli_hmap_next(s->uniforms, entry))) {
             const struct uniformprograminfo *active_uniform =
                 ngli_hmap_get(program->active_uniforms, entry->key);
+
+            /* Members of a block with an instance name are prefixed with the block name */
+            if (!active_uniform && s->uniforms_block) {
+                char name[MAX_ID_LEN];
+                snprintf(name, sizeof(name), "%s.%s", s->uniforms_block, entry->key);
+                active_uniform = ngli_hmap_get(program->active_uniforms, name);
+            }
+
             if (!active_uniform) {
                 LOG(WARNING, "uniform %s attached to %s not found in %s",
                     entry->key, node->label, s->program->label);
                 continue;
             }
 
+            struct darray *pairs = &s->uniform_pairs;
+            if (s->uniforms_block_info &&
+                active_uniform->block_index == s->uniforms_block_info->block_index) {
+                if (check_block_uniform_type(entry->data, active_uniform) < 0) {
+                    LOG(ERROR, "uniform %s attached to %s does not match the type of its member "
+                        "in the uniform block %s", entry->key, node->label, s->uniforms_block);
+                    return -1;
+                }
+                pairs = &s->block_uniform_pairs;
+            }
+
             struct nodeprograminfopair pair = {
                 .node = entry->data,
                 .program_info = (void *)active_uniform,
             };
             snprintf(pair.name, sizeof(pair.name), "%s", entry->key);
-            if (!ngli_darray_push(&s->uniform_pairs, &pair))
+            if (!ngli_darray_push(pairs, &pair))
                 return -1;
         }
     }
@@ -560,6 +781,12 @@ void ngli_pipeline_uninit(struct ngl_node *node)
 
     ngli_darray_reset(&s->texture_pairs);
     ngli_darray_reset(&s->uniform_pairs);
+    ngli_darray_reset(&s->block_uniform_pairs);
+
+    ngli_buffer_free(&s->uniforms_buffer);
+    ngli_free(s->uniforms_data);
+    s->uniforms_data = NULL;
+    s->uniforms_block_info = NULL;
 
     struct darray *buffer_pairs = &s->buffer_pairs;
     struct nodeprograminfopair *pairs = ngli_darray_data(buffer_pairs);
@@ -616,6 +843,7 @@ int ngli_pipeline_upload_data(struct ngl_node *node)
     int ret;
 
     if ((ret = update_uniforms(node)) < 0 ||
+        (ret = update_uniforms_block(node)) < 0 ||
         (ret = update_images_and_samplers(node)) < 0 ||
         (ret = update_buffers(node)) < 0)
         return ret;
@@ -0,0 +1,340 @@
+/*
+ * Copyright 2018 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#include "log.h"
+#include "math_utils.h"
+#include "nodegl.h"
+#include "nodes.h"
+#include "plan.h"
+#include "utils.h"
+
+static int push_op(struct darray *ops, int type, struct ngl_node *node)
+{
+    const struct plan_op op = {.type = type, .node = node, .jump = -1};
+    if (!ngli_darray_push(ops, &op))
+        return -1;
+    return ngli_darray_count(ops) - 1;
+}
+
+static void set_jump(struct darray *ops, int index)
+{
+    struct plan_op *op = ngli_darray_get(ops, index);
+    op->jump = ngli_darray_count(ops);
+}
+
+/*
+ * Nodes shared by several parents are kept as regular operations: linearizing
+ * them would duplicate their subtree operations for every parent. So are the
+ * groups with instancing batches, which draw some of their children at once.
+ */
+static int get_flattened_id(const struct ngl_node *node)
+{
+    if (node->ctx_refcount > 1)
+        return -1;
+    if (node->class->id == NGL_NODE_GROUP) {
+        const struct group_priv *s = node->priv_data;
+        if (ngli_darray_count(&s->batches))
+            return -1;
+    }
+    return node->class->id;
+}
+
+static int compile_update(struct darray *ops, struct ngl_node *node)
+{
+    if (!node->class->update)
+        return 0;
+
+    int enter_type = PLAN_OP_UPDATE_ENTER;
+    int leave_type = PLAN_OP_UPDATE_LEAVE;
+
+    switch (get_flattened_id(node)) {
+        case NGL_NODE_GROUP:
+        case NGL_NODE_TRANSFORM:
+        case NGL_NODE_GRAPHICCONFIG:
+            leave_type = PLAN_OP_UPDATE_LEAVE_FORWARD;
+            break;
+        case NGL_NODE_ROTATE:
+        case NGL_NODE_TRANSLATE:
+        case NGL_NODE_SCALE:
+        case NGL_NODE_CAMERA:
+            break;
+        case NGL_NODE_USERSWITCH:
+            enter_type = PLAN_OP_UPDATE_ENTER_USERSWITCH;
+            leave_type = PLAN_OP_UPDATE_LEAVE_FORWARD;
+            break;
+        case NGL_NODE_TIMERANGEFILTER:
+            enter_type = PLAN_OP_UPDATE_ENTER_TIMERANGEFILTER;
+            leave_type = PLAN_OP_UPDATE_LEAVE_TIMERANGEFILTER;
+            break;
+        default:
+            return push_op(ops, PLAN_OP_UPDATE, node) < 0 ? -1 : 0;
+    }
+
+    const int enter = push_op(ops, enter_type, node);
+    if (enter < 0)
+        return -1;
+
+    /*
+     * The children are updated before their parent, which will then find
+     * them up-to-date when calling ngli_node_update() on them.
+     */
+    struct darray *children_array = &node->children;
+    struct ngl_node **children = ngli_darray_data(children_array);
+    for (int i = 0; i < ngli_darray_count(children_array); i++) {
+        int ret = compile_update(ops, children[i]);
+        if (ret < 0)
+            return ret;
+    }
+
+    if (push_op(ops, leave_type, node) < 0)
+        return -1;
+    set_jump(ops, enter);
+
+    return 0;
+}
+
+static int compile_draw(struct darray *ops, struct ngl_node *node)
+{
+    if (!node->class->draw)
+        return 0;
+
+    int push_type;
+    int pop_type = -1;
+    struct ngl_node *child;
+
+    switch (get_flattened_id(node)) {
+        case NGL_NODE_GROUP: {
+            const struct group_priv *s = node->priv_data;
+            for (int i = 0; i < s->nb_children; i++) {
+                int ret = compile_draw(ops, s->draw_children[i]);
+                if (ret < 0)
+                    return ret;
+            }
+            return 0;
+        }
+        case NGL_NODE_ROTATE:
+        case NGL_NODE_TRANSLATE:
+        case NGL_NODE_SCALE:
+        case NGL_NODE_TRANSFORM: {
+            const struct transform_priv *s = node->priv_data;
+            push_type = PLAN_OP_DRAW_PUSH_TRANSFORM;
+            pop_type = PLAN_OP_DRAW_POP_TRANSFORM;
+            child = s->child;
+            break;
+        }
+        case NGL_NODE_CAMERA: {
+            const struct camera_priv *s = node->priv_data;
+            push_type = PLAN_OP_DRAW_PUSH_CAMERA;
+            pop_type = PLAN_OP_DRAW_POP_CAMERA;
+            child = s->child;
+            break;
+        }
+        case NGL_NODE_GRAPHICCONFIG: {
+            const struct graphicconfig_priv *s = node->priv_data;
+            push_type = PLAN_OP_DRAW_PUSH_GRAPHICCONFIG;
+            pop_type = PLAN_OP_DRAW_POP_GRAPHICCONFIG;
+            child = s->child;
+            break;
+        }
+        case NGL_NODE_USERSWITCH: {
+            const struct userswitch_priv *s = node->priv_data;
+            push_type = PLAN_OP_DRAW_SKIP_USERSWITCH;
+            child = s->child;
+            break;
+        }
+        case NGL_NODE_TIMERANGEFILTER: {
+            const struct timerangefilter_priv *s = node->priv_data;
+            push_type = PLAN_OP_DRAW_SKIP_TIMERANGEFILTER;
+            child = s->child;
+            break;
+        }
+        default:
+            return push_op(ops, PLAN_OP_DRAW, node) < 0 ? -1 : 0;
+    }
+
+    const int push = push_op(ops, push_type, node);
+    if (push < 0)
+        return -1;
+
+    int ret = compile_draw(ops, child);
+    if (ret < 0)
+        return ret;
+
+    if (pop_type >= 0 && push_op(ops, pop_type, node) < 0)
+        return -1;
+    set_jump(ops, push);
+
+    return 0;
+}
+
+int ngli_plan_init(struct plan *plan, struct ngl_node *scene)
+{
+    ngli_darray_init(&plan->update_ops, sizeof(struct plan_op), 0);
+    ngli_darray_init(&plan->draw_ops, sizeof(struct plan_op), 0);
+    ngli_darray_init(&plan->time_stack, sizeof(double), 0);
+
+    int ret;
+    if ((ret = compile_update(&plan->update_ops, scene)) < 0 ||
+        (ret = compile_draw(&plan->draw_ops, scene)) < 0) {
+        ngli_plan_reset(plan);
+        return ret;
+    }
+
+    LOG(DEBUG, "plan of %s compiled with %d update and %d draw operations", scene->label,
+        ngli_darray_count(&plan->update_ops), ngli_darray_count(&plan->draw_ops));
+
+    return 0;
+}
+
+int ngli_plan_update(struct plan *plan, double t)
+{
+    const struct plan_op *ops = ngli_darray_data(&plan->update_ops);
+    const int nb_ops = ngli_darray_count(&plan->update_ops);
+
+    plan->time_stack.count = 0;
+
+    int i = 0;
+    while (i < nb_ops) {
+        const struct plan_op *op = &ops[i++];
+        struct ngl_node *node = op->node;
+
+        switch (op->type) {
+            case PLAN_OP_UPDATE:
+            case PLAN_OP_UPDATE_LEAVE: {
+                int ret = ngli_node_update(node, t);
+                if (ret < 0)
+                    return ret;
+                break;
+            }
+            case PLAN_OP_UPDATE_ENTER:
+                if (ngli_node_is_up_to_date(node, t))
+                    i = op->jump;
+                break;
+            case PLAN_OP_UPDATE_ENTER_USERSWITCH: {
+                const struct userswitch_priv *s = node->priv_data;
+                if (ngli_node_is_up_to_date(node, t)) {
+                    i = op->jump;
+                } else if (!s->enabled) {
+                    ngli_node_set_updated(node, t);
+                    i = op->jump;
+                }
+                break;
+            }
+            case PLAN_OP_UPDATE_ENTER_TIMERANGEFILTER: {
+                if (ngli_node_is_up_to_date(node, t)) {
+                    i = op->jump;
+                    break;
+                }
+                double child_t = t;
+                if (!ngli_timerangefilter_update_state(node, &child_t)) {
+                    ngli_node_set_updated(node, t);
+                    i = op->jump;
+                    break;
+                }
+                if (!ngli_darray_push(&plan->time_stack, &t))
+                    return -1;
+                t = child_t;
+                break;
+            }
+            case PLAN_OP_UPDATE_LEAVE_FORWARD:
+                ngli_node_set_updated(node, t);
+                break;
+            case PLAN_OP_UPDATE_LEAVE_TIMERANGEFILTER:
+                t = *(double *)ngli_darray_pop(&plan->time_stack);
+                ngli_node_set_updated(node, t);
+                break;
+            default:
+                ngli_assert(0);
+        }
+    }
+
+    return 0;
+}
+
+void ngli_plan_draw(struct plan *plan)
+{
+    const struct plan_op *ops = ngli_darray_data(&plan->draw_ops);
+    const int nb_ops = ngli_darray_count(&plan->draw_ops);
+
+    int i = 0;
+    while (i < nb_ops) {
+        const struct plan_op *op = &ops[i++];
+        struct ngl_node *node = op->node;
+
+        switch (op->type) {
+            case PLAN_OP_DRAW:
+                ngli_node_draw(node);
+                break;
+            case PLAN_OP_DRAW_PUSH_TRANSFORM: {
+                struct darray *stack = &node->ctx->modelview_matrix_stack;
+                const struct transform_priv *s = node->priv_data;
+                float *next_matrix = ngli_darray_push(stack, NULL);
+                if (!next_matrix) {
+                    i = op->jump;
+                    break;
+                }
+                const float *prev_matrix = ngli_darray_get(stack, ngli_darray_count(stack) - 2);
+                ngli_mat4_mul(next_matrix, prev_matrix, s->matrix);
+                break;
+            }
+            case PLAN_OP_DRAW_POP_TRANSFORM:
+                ngli_darray_pop(&node->ctx->modelview_matrix_stack);
+                break;
+            case PLAN_OP_DRAW_PUSH_CAMERA:
+                if (ngli_camera_draw_begin(node) < 0)
+                    i = op->jump;
+                break;
+            case PLAN_OP_DRAW_POP_CAMERA:
+                ngli_camera_draw_end(node);
+                break;
+            case PLAN_OP_DRAW_PUSH_GRAPHICCONFIG:
+                ngli_graphicconfig_honor(node, 0);
+                break;
+            case PLAN_OP_DRAW_POP_GRAPHICCONFIG:
+                ngli_graphicconfig_honor(node, 1);
+                break;
+            case PLAN_OP_DRAW_SKIP_USERSWITCH: {
+                const struct userswitch_priv *s = node->priv_data;
+                if (!s->enabled)
+                    i = op->jump;
+                break;
+            }
+            case PLAN_OP_DRAW_SKIP_TIMERANGEFILTER: {
+                const struct timerangefilter_priv *s = node->priv_data;
+                if (!s->drawme) {
+                    TRACE("%s @ %p not marked for drawing, skip it", node->label, node);
+                    i = op->jump;
+                }
+                break;
+            }
+            default:
+                ngli_assert(0);
+        }
+    }
+}
+
+void ngli_plan_reset(struct plan *plan)
+{
+    ngli_darray_reset(&plan->update_ops);
+    ngli_darray_reset(&plan->draw_ops);
+    ngli_darray_reset(&plan->time_stack);
+}
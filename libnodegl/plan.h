@@ -0,0 +1,75 @@
+/*
+ * Copyright 2018 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#ifndef PLAN_H
+#define PLAN_H
+
+#include "darray.h"
+
+struct ngl_node;
+
+/*
+ * A plan is a linearized version of the update and draw passes of a scene:
+ * container nodes (groups, transforms, cameras, ...) are replaced with
+ * operations surrounding the operations of their subtree, and jumps are used
+ * to skip subtrees which do not need to be processed.
+ */
+enum {
+    /* Update operations */
+    PLAN_OP_UPDATE,                 /* regular update of a node subtree */
+    PLAN_OP_UPDATE_ENTER,           /* skip the subtree if up-to-date */
+    PLAN_OP_UPDATE_ENTER_USERSWITCH,
+    PLAN_OP_UPDATE_ENTER_TIMERANGEFILTER,
+    PLAN_OP_UPDATE_LEAVE,           /* update of the node itself */
+    PLAN_OP_UPDATE_LEAVE_FORWARD,   /* the node has nothing to update itself */
+    PLAN_OP_UPDATE_LEAVE_TIMERANGEFILTER,
+
+    /* Draw operations */
+    PLAN_OP_DRAW,                   /* regular draw of a node subtree */
+    PLAN_OP_DRAW_PUSH_TRANSFORM,
+    PLAN_OP_DRAW_POP_TRANSFORM,
+    PLAN_OP_DRAW_PUSH_CAMERA,
+    PLAN_OP_DRAW_POP_CAMERA,
+    PLAN_OP_DRAW_PUSH_GRAPHICCONFIG,
+    PLAN_OP_DRAW_POP_GRAPHICCONFIG,
+    PLAN_OP_DRAW_SKIP_USERSWITCH,
+    PLAN_OP_DRAW_SKIP_TIMERANGEFILTER,
+};
+
+struct plan_op {
+    int type;
+    struct ngl_node *node;
+    int jump; /* index of the operation following the node subtree */
+};
+
+struct plan {
+    struct darray update_ops;
+    struct darray draw_ops;
+    struct darray time_stack;
+};
+
+int ngli_plan_init(struct plan *plan, struct ngl_node *scene);
+int ngli_plan_update(struct plan *plan, double t);
+void ngli_plan_draw(struct plan *plan);
+void ngli_plan_reset(struct plan *plan);
+
+#endif
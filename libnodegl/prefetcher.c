@@ -0,0 +1,271 @@
+/*
+ * Copyright 2018 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#include <pthread.h>
+
+#include "log.h"
+#include "memory.h"
+#include "nodes.h"
+#include "prefetcher.h"
+#include "utils.h"
+
+struct job {
+    prefetcher_job_func func;
+    void *arg;
+    int started;
+    int done;
+    int ret;
+    GLsync fence;
+    struct job *next;
+};
+
+struct prefetcher {
+    struct glcontext *gl;
+    pthread_t tid;
+
+    pthread_mutex_t lock;
+    pthread_cond_t cond_wkr;
+    pthread_cond_t cond_ctl;
+    struct job *jobs; /* pushed and not yet collected, in push order */
+    int init_ret;     /* 1 once the shared context is ready, < 0 on error */
+    int stop;
+};
+
+static struct job *get_next_job(struct prefetcher *s)
+{
+    for (struct job *job = s->jobs; job; job = job->next)
+        if (!job->started)
+            return job;
+    return NULL;
+}
+
+static int prefetch_node(struct glcontext *gl, void *arg)
+{
+    struct ngl_node *node = arg;
+
+    TRACE("PREFETCH %s @ %p (async)", node->label, node);
+    struct tracer *tracer = __atomic_load_n(&node->ctx->tracer, __ATOMIC_ACQUIRE);
+    NGLI_TRACER_BEGIN(tracer, "prefetch", node);
+    struct ngl_memory_stats *prev_owner = ngli_memstats_set_owner(&node->memstats);
+    int ret = node->class->prefetch(node);
+    ngli_memstats_set_owner(prev_owner);
+    NGLI_TRACER_END(tracer);
+    return ret;
+}
+
+static void run_job(struct glcontext *gl, struct job *job)
+{
+    /*
+     * The objects bound by the previous jobs may have been deleted (and
+     * their names reused) from the rendering thread in the meantime, which
+     * only updates the binding shadow of its own context.
+     */
+    ngli_glbindings_invalidate();
+
+    job->ret = job->func(gl, job->arg);
+
+    /*
+     * The fence is waited for by the thread collecting the node so the
+     * objects it created are complete before their first use.
+     */
+    job->fence = ngli_glFenceSync(gl, GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    ngli_glFlush(gl);
+}
+
+static void *prefetch_thread(void *arg)
+{
+    struct prefetcher *s = arg;
+
+    ngli_thread_set_name("ngl-prefetch");
+
+    struct glcontext *gl = ngli_glcontext_new_shared(s->gl);
+    int init_ret = 1;
+    if (!gl) {
+        LOG(ERROR, "could not create the prefetch GL context");
+        init_ret = -1;
+    } else if (!(gl->features & NGLI_FEATURE_SYNC)) {
+        LOG(ERROR, "the prefetch thread requires the sync feature");
+        init_ret = -1;
+    }
+
+    pthread_mutex_lock(&s->lock);
+    s->init_ret = init_ret;
+    pthread_cond_signal(&s->cond_ctl);
+    while (init_ret > 0) {
+        struct job *job;
+        while (!s->stop && !(job = get_next_job(s)))
+            pthread_cond_wait(&s->cond_wkr, &s->lock);
+        if (s->stop)
+            break;
+        job->started = 1;
+        pthread_mutex_unlock(&s->lock);
+
+        run_job(gl, job);
+
+        pthread_mutex_lock(&s->lock);
+        job->done = 1;
+        pthread_cond_broadcast(&s->cond_ctl);
+    }
+    pthread_mutex_unlock(&s->lock);
+
+    ngli_glcontext_freep(&gl);
+    return NULL;
+}
+
+struct prefetcher *ngli_prefetcher_create(struct glcontext *gl)
+{
+    struct prefetcher *s = ngli_calloc(1, sizeof(*s));
+    if (!s)
+        return NULL;
+    s->gl = gl;
+
+    if (pthread_mutex_init(&s->lock, NULL) ||
+        pthread_cond_init(&s->cond_wkr, NULL) ||
+        pthread_cond_init(&s->cond_ctl, NULL)) {
+        pthread_cond_destroy(&s->cond_wkr);
+        pthread_mutex_destroy(&s->lock);
+        ngli_free(s);
+        return NULL;
+    }
+
+    if (pthread_create(&s->tid, NULL, prefetch_thread, s)) {
+        pthread_cond_destroy(&s->cond_ctl);
+        pthread_cond_destroy(&s->cond_wkr);
+        pthread_mutex_destroy(&s->lock);
+        ngli_free(s);
+        return NULL;
+    }
+
+    pthread_mutex_lock(&s->lock);
+    while (!s->init_ret)
+        pthread_cond_wait(&s->cond_ctl, &s->lock);
+    const int init_ret = s->init_ret;
+    pthread_mutex_unlock(&s->lock);
+
+    if (init_ret < 0)
+        ngli_prefetcher_freep(&s);
+
+    return s;
+}
+
+int ngli_prefetcher_push_job(struct prefetcher *s, prefetcher_job_func func, void *arg)
+{
+    struct job *job = ngli_calloc(1, sizeof(*job));
+    if (!job)
+        return -1;
+    job->func = func;
+    job->arg = arg;
+
+    pthread_mutex_lock(&s->lock);
+    struct job **jobp = &s->jobs;
+    while (*jobp)
+        jobp = &(*jobp)->next;
+    *jobp = job;
+    pthread_cond_signal(&s->cond_wkr);
+    pthread_mutex_unlock(&s->lock);
+
+    return 0;
+}
+
+void ngli_prefetcher_wait_idle(struct prefetcher *s)
+{
+    pthread_mutex_lock(&s->lock);
+    for (;;) {
+        const struct job *job = s->jobs;
+        while (job && !(job->started && !job->done))
+            job = job->next;
+        if (!job)
+            break;
+        pthread_cond_wait(&s->cond_ctl, &s->lock);
+    }
+    pthread_mutex_unlock(&s->lock);
+}
+
+int ngli_prefetcher_push(struct prefetcher *s, struct ngl_node *node)
+{
+    return ngli_prefetcher_push_job(s, prefetch_node, node);
+}
+
+int ngli_prefetcher_collect_job(struct prefetcher *s, void *arg, int wait)
+{
+    pthread_mutex_lock(&s->lock);
+    struct job **jobp = &s->jobs;
+    while (*jobp && (*jobp)->arg != arg)
+        jobp = &(*jobp)->next;
+    struct job *job = *jobp;
+    ngli_assert(job);
+    if (!job->done && !wait) {
+        pthread_mutex_unlock(&s->lock);
+        return 0;
+    }
+    while (!job->done)
+        pthread_cond_wait(&s->cond_ctl, &s->lock);
+    *jobp = job->next;
+    pthread_mutex_unlock(&s->lock);
+
+    if (job->fence) {
+        ngli_glWaitSync(s->gl, job->fence, 0, GL_TIMEOUT_IGNORED);
+        ngli_glDeleteSync(s->gl, job->fence);
+    }
+
+    /* Same as in run_job(), the other way around */
+    ngli_glbindings_invalidate();
+
+    const int ret = job->ret;
+    ngli_free(job);
+    return ret < 0 ? ret : 1;
+}
+
+int ngli_prefetcher_collect(struct prefetcher *s, struct ngl_node *node, int wait)
+{
+    return ngli_prefetcher_collect_job(s, node, wait);
+}
+
+void ngli_prefetcher_freep(struct prefetcher **sp)
+{
+    struct prefetcher *s = *sp;
+
+    if (!s)
+        return;
+
+    pthread_mutex_lock(&s->lock);
+    s->stop = 1;
+    pthread_cond_signal(&s->cond_wkr);
+    pthread_mutex_unlock(&s->lock);
+    pthread_join(s->tid, NULL);
+
+    /* Nodes are collected when released, so this should not happen */
+    struct job *job = s->jobs;
+    while (job) {
+        struct job *next = job->next;
+        if (job->fence)
+            ngli_glDeleteSync(s->gl, job->fence);
+        ngli_free(job);
+        job = next;
+    }
+
+    pthread_cond_destroy(&s->cond_ctl);
+    pthread_cond_destroy(&s->cond_wkr);
+    pthread_mutex_destroy(&s->lock);
+    ngli_free(*sp);
+    *sp = NULL;
+}
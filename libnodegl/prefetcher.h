@@ -0,0 +1,71 @@
+/*
+ * Copyright 2018 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef PREFETCHER_H
+#define PREFETCHER_H
+
+#include "glcontext.h"
+
+struct ngl_node;
+struct prefetcher;
+
+typedef int (*prefetcher_job_func)(struct glcontext *gl, void *arg);
+
+/*
+ * Spawn a thread owning a GL context sharing its objects with gl, on which
+ * the prefetch() of the nodes can be run ahead of their first use. Returns
+ * NULL if the platform is not able to provide such a context.
+ */
+struct prefetcher *ngli_prefetcher_create(struct glcontext *gl);
+
+/*
+ * Queue the prefetch() of the node on the prefetch thread. The node must not
+ * be accessed until it has been collected.
+ */
+int ngli_prefetcher_push(struct prefetcher *s, struct ngl_node *node);
+
+/*
+ * Collect the prefetch of a node previously pushed, optionally waiting for
+ * the prefetch thread to complete it. The GL commands of the prefetch are
+ * ordered before the next commands of the calling thread.
+ *
+ * Returns 1 if the node has been collected, 0 if it is not ready yet (only if
+ * wait is 0) or the error returned by prefetch().
+ */
+int ngli_prefetcher_collect(struct prefetcher *s, struct ngl_node *node, int wait);
+
+/*
+ * Same as ngli_prefetcher_push() and ngli_prefetcher_collect() for any job
+ * needing a GL context, identified by its argument. The job function is
+ * called with the GL context of the prefetch thread.
+ */
+int ngli_prefetcher_push_job(struct prefetcher *s, prefetcher_job_func func, void *arg);
+int ngli_prefetcher_collect_job(struct prefetcher *s, void *arg, int wait);
+
+/*
+ * Wait for the prefetch currently running on the prefetch thread, if any, to
+ * complete.
+ */
+void ngli_prefetcher_wait_idle(struct prefetcher *s);
+
+void ngli_prefetcher_freep(struct prefetcher **sp);
+
+#endif /* PREFETCHER_H */
@@ -19,6 +19,7 @@
  * under the License.
  */
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -26,44 +27,561 @@
 #include "log.h"
 #include "memory.h"
 #include "nodes.h"
+#include "prefetcher.h"
 #include "program.h"
+#include "program_cache.h"
+#include "utils.h"
+
+enum {
+    SHADER_VERTEX,
+    SHADER_FRAGMENT,
+    SHADER_COMPUTE,
+    NB_SHADERS
+};
+
+static const GLenum shader_types[NB_SHADERS] = {
+    [SHADER_VERTEX]   = GL_VERTEX_SHADER,
+    [SHADER_FRAGMENT] = GL_FRAGMENT_SHADER,
+    [SHADER_COMPUTE]  = GL_COMPUTE_SHADER,
+};
+
+#define KEY_LEN (NB_SHADERS * 8 + 1)
+
+struct program_build {
+    char key[KEY_LEN];
+    const char *sources[NB_SHADERS];
+    GLuint shader_ids[NB_SHADERS];
+    GLuint program_id;
+    int async;       /* built on the prefetch thread */
+    int retrievable; /* binary to be stored in the program cache */
+    int cached;      /* loaded from the program cache */
+};
+
+/*
+ * Issue the compilation and link commands of the program without querying
+ * their status, which would wait for them to complete.
+ */
+static void build_issue(struct glcontext *gl, struct program_build *b)
+{
+    b->program_id = ngli_glCreateProgram(gl);
+    for (int i = 0; i < NB_SHADERS; i++) {
+        if (!b->sources[i])
+            continue;
+        GLuint shader = ngli_glCreateShader(gl, shader_types[i]);
+        ngli_glShaderSource(gl, shader, 1, &b->sources[i], NULL);
+        ngli_glCompileShader(gl, shader);
+        ngli_glAttachShader(gl, b->program_id, shader);
+        b->shader_ids[i] = shader;
+    }
+    if (b->retrievable)
+        ngli_glProgramParameteri(gl, b->program_id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    ngli_glLinkProgram(gl, b->program_id);
+}
+
+static void build_reset(struct glcontext *gl, struct program_build *b)
+{
+    for (int i = 0; i < NB_SHADERS; i++) {
+        if (b->shader_ids[i])
+            ngli_glDeleteShader(gl, b->shader_ids[i]);
+        b->shader_ids[i] = 0;
+    }
+    if (b->program_id)
+        ngli_glDeleteProgram(gl, b->program_id);
+    b->program_id = 0;
+}
+
+/*
+ * Check the status of an issued build and release its shaders. Returns the
+ * program id, or 0 on error (the program is then deleted).
+ */
+static GLuint build_complete(struct glcontext *gl, struct program_build *b)
+{
+    for (int i = 0; i < NB_SHADERS; i++) {
+        if (b->shader_ids[i] &&
+            ngli_program_check_status(gl, b->shader_ids[i], GL_COMPILE_STATUS) < 0) {
+            build_reset(gl, b);
+            return 0;
+        }
+    }
+    if (ngli_program_check_status(gl, b->program_id, GL_LINK_STATUS) < 0) {
+        build_reset(gl, b);
+        return 0;
+    }
+
+    const GLuint program_id = b->program_id;
+    b->program_id = 0;
+    build_reset(gl, b);
+    return program_id;
+}
+
+static int build_job(struct glcontext *gl, void *arg)
+{
+    struct program_build *b = arg;
+    build_issue(gl, b);
+    b->program_id = build_complete(gl, b);
+    return b->program_id ? 0 : -1;
+}
 
 GLuint ngli_program_load(struct glcontext *gl, const char *vertex, const char *fragment)
 {
-    GLuint program = ngli_glCreateProgram(gl);
-    GLuint vertex_shader = ngli_glCreateShader(gl, GL_VERTEX_SHADER);
-    GLuint fragment_shader = ngli_glCreateShader(gl, GL_FRAGMENT_SHADER);
+    struct program_build b = {
+        .sources[SHADER_VERTEX]   = vertex,
+        .sources[SHADER_FRAGMENT] = fragment,
+    };
+    build_issue(gl, &b);
+    return build_complete(gl, &b);
+}
+
+/*
+ * Load the program from its cached binary, if any. A binary rejected by the
+ * driver is not an error: the program is then built from its sources.
+ */
+static int build_load_cached(struct ngl_ctx *s, struct program_build *b)
+{
+    struct glcontext *gl = s->glcontext;
+
+    if (!s->program_cache)
+        return 0;
+
+    uint32_t format;
+    void *data;
+    int size;
+    int ret = ngli_program_cache_read(s->program_cache, b->sources, NB_SHADERS, &format, &data, &size);
+    if (ret <= 0)
+        return ret;
+
+    GLint status = GL_FALSE;
+    GLuint program_id = ngli_glCreateProgram(gl);
+    ngli_glProgramBinary(gl, program_id, format, data, size);
+    ngli_glGetProgramiv(gl, program_id, GL_LINK_STATUS, &status);
+    ngli_free(data);
+
+    ngli_program_cache_validate(s->program_cache, status == GL_TRUE);
+    if (status != GL_TRUE) {
+        LOG(DEBUG, "cached program binary rejected by the driver, building the program");
+        ngli_glDeleteProgram(gl, program_id);
+        return 0;
+    }
+
+    b->program_id = program_id;
+    b->cached = 1;
+    return 1;
+}
 
-    ngli_glShaderSource(gl, vertex_shader, 1, &vertex, NULL);
-    ngli_glCompileShader(gl, vertex_shader);
-    if (ngli_program_check_status(gl, vertex_shader, GL_COMPILE_STATUS) < 0)
+static void build_store(struct ngl_ctx *s, const struct program_build *b, GLuint program_id)
+{
+    struct glcontext *gl = s->glcontext;
+
+    if (!program_id || !b->retrievable)
+        return;
+
+    GLint size = 0;
+    ngli_glGetProgramiv(gl, program_id, GL_PROGRAM_BINARY_LENGTH, &size);
+    if (size <= 0)
+        return;
+
+    void *data = ngli_malloc(size);
+    if (!data)
+        return;
+
+    GLenum format;
+    ngli_glGetProgramBinary(gl, program_id, size, &size, &format, data);
+    ngli_program_cache_write(s->program_cache, b->sources, NB_SHADERS, format, data, size);
+    ngli_free(data);
+}
+
+static int sources_match(const char * const *a, const char * const *b)
+{
+    for (int i = 0; i < NB_SHADERS; i++) {
+        if (!a[i] != !b[i] || (a[i] && strcmp(a[i], b[i])))
+            return 0;
+    }
+    return 1;
+}
+
+/*
+ * The key only identifies the candidates sharing a program: their sources
+ * are always compared on lookup.
+ */
+static void get_key(char *key, const char * const *sources)
+{
+    for (int i = 0; i < NB_SHADERS; i++) {
+        if (sources[i])
+            snprintf(key + i * 8, 9, "%08x", ngli_crc32(sources[i]));
+        else
+            memcpy(key + i * 8, "--------", 9);
+    }
+}
+
+/*
+ * Values last uploaded to a uniform of the program, which keeps them until
+ * they are uploaded again
+ */
+struct uniform_shadow {
+    GLint location;
+    int offset; /* in the shadow data */
+    int size;
+    int valid_size; /* leading bytes holding uploaded values */
+};
+
+struct program_entry {
+    struct program program; /* must be first, see ngli_program_unrefp() */
+    char key[KEY_LEN];
+    int registered;
+    int refcount;
+    char *sources[NB_SHADERS];
+    struct uniform_shadow *uniform_shadows; /* sorted by location */
+    int nb_uniform_shadows;
+    uint8_t *uniform_shadow_data;
+};
+
+static struct program_entry *get_registered(const struct ngl_ctx *s, const char *key,
+                                            const char * const *sources)
+{
+    if (!s->programs)
+        return NULL;
+    struct program_entry *e = ngli_hmap_get(s->programs, key);
+    if (!e || !sources_match((const char * const *)e->sources, sources))
+        return NULL;
+    return e;
+}
+
+int ngli_program_build_start(struct ngl_ctx *s, const char *vertex, const char *fragment,
+                             const char *compute)
+{
+    struct glcontext *gl = s->glcontext;
+    const char *sources[NB_SHADERS] = {vertex, fragment, compute};
+    char key[KEY_LEN];
+    get_key(key, sources);
+
+    /*
+     * Nothing to build if a node with the same shaders already holds the
+     * program, or if its build has already been started (by a node shared by
+     * several parents or a node with the same shaders).
+     */
+    if (get_registered(s, key, sources))
+        return 0;
+    struct program_build **builds = ngli_darray_data(&s->program_builds);
+    for (int i = 0; i < ngli_darray_count(&s->program_builds); i++)
+        if (!strcmp(builds[i]->key, key) && sources_match(builds[i]->sources, sources))
+            return 0;
+
+    struct program_build *b = ngli_calloc(1, sizeof(*b));
+    if (!b)
+        return -1;
+    memcpy(b->key, key, sizeof(key));
+    memcpy(b->sources, sources, sizeof(sources));
+
+    if (!ngli_darray_push(&s->program_builds, &b)) {
+        ngli_free(b);
+        return -1;
+    }
+
+    int ret = build_load_cached(s, b);
+    if (ret < 0)
+        return ret;
+    if (ret > 0)
+        return 0;
+    b->retrievable = s->program_cache != NULL;
+
+    /*
+     * With GL_KHR_parallel_shader_compile, the driver compiles and links the
+     * issued programs concurrently until their status is queried. Otherwise,
+     * the prefetch thread (if any) builds them while the context goes on
+     * with the initialization of the other nodes.
+     */
+    if (!(gl->features & NGLI_FEATURE_KHR_PARALLEL_SHADER_COMPILE) && s->prefetcher &&
+        ngli_prefetcher_push_job(s->prefetcher, build_job, b) == 0) {
+        b->async = 1;
+        return 0;
+    }
+
+    build_issue(gl, b);
+    return 0;
+}
+
+static GLuint build_finish(struct ngl_ctx *s, struct program_build *b)
+{
+    struct glcontext *gl = s->glcontext;
+
+    GLuint program_id;
+    if (b->cached) {
+        program_id = b->program_id;
+        b->program_id = 0;
+        return program_id;
+    } else if (b->async) {
+        /* The job must only be collected once */
+        b->async = 0;
+        if (ngli_prefetcher_collect_job(s->prefetcher, b, 1) < 0)
+            return 0;
+        program_id = b->program_id;
+        b->program_id = 0;
+    } else {
+        program_id = build_complete(gl, b);
+    }
+    build_store(s, b, program_id);
+    return program_id;
+}
+
+static void build_freep(struct ngl_ctx *s, struct program_build **bp)
+{
+    struct program_build *b = *bp;
+    if (!b)
+        return;
+    if (b->async)
+        ngli_prefetcher_collect_job(s->prefetcher, b, 1);
+    build_reset(s->glcontext, b);
+    ngli_free(b);
+    *bp = NULL;
+}
+
+/*
+ * Complete the build started with the same shaders, or build the program
+ * synchronously if there is none. Returns the program id or 0 on error.
+ */
+static GLuint build_program(struct ngl_ctx *s, const char *key, const char * const *sources)
+{
+    struct program_build **builds = ngli_darray_data(&s->program_builds);
+    const int nb_builds = ngli_darray_count(&s->program_builds);
+    for (int i = 0; i < nb_builds; i++) {
+        struct program_build *b = builds[i];
+        if (strcmp(b->key, key) || !sources_match(b->sources, sources))
+            continue;
+
+        builds[i] = builds[nb_builds - 1];
+        s->program_builds.count--;
+
+        const GLuint program_id = build_finish(s, b);
+        build_freep(s, &b);
+        return program_id;
+    }
+
+    struct program_build b = {0};
+    memcpy(b.sources, sources, sizeof(b.sources));
+    int ret = build_load_cached(s, &b);
+    if (ret < 0)
+        return 0;
+    if (ret > 0)
+        return b.program_id;
+    b.retrievable = s->program_cache != NULL;
+    build_issue(s->glcontext, &b);
+    const GLuint program_id = build_complete(s->glcontext, &b);
+    build_store(s, &b, program_id);
+    return program_id;
+}
+
+void ngli_program_build_reset(struct ngl_ctx *s)
+{
+    struct program_build **builds = ngli_darray_data(&s->program_builds);
+    for (int i = 0; i < ngli_darray_count(&s->program_builds); i++)
+        build_freep(s, &builds[i]);
+    s->program_builds.count = 0;
+}
+
+static int probe_program(struct program *program, const char *label, struct glcontext *gl,
+                         int probe_attributes)
+{
+    program->active_uniforms = ngli_program_probe_uniforms(label, gl, program->id);
+    program->active_buffer_blocks = ngli_program_probe_buffer_blocks(label, gl, program->id);
+    if (probe_attributes)
+        program->active_attributes = ngli_program_probe_attributes(label, gl, program->id);
+    if (!program->active_uniforms || !program->active_buffer_blocks ||
+        (probe_attributes && !program->active_attributes))
+        return -1;
+    return 0;
+}
+
+static int get_uniform_type_size(GLenum type)
+{
+    switch (type) {
+        case GL_FLOAT:
+        case GL_INT:
+        case GL_BOOL:
+        case GL_SAMPLER_2D:
+        case GL_SAMPLER_3D:
+        case GL_SAMPLER_EXTERNAL_OES:
+        case GL_SAMPLER_EXTERNAL_2D_Y2Y_EXT:  return 4;
+        case GL_FLOAT_VEC2:                   return 4 * 2;
+        case GL_FLOAT_VEC3:                   return 4 * 3;
+        case GL_FLOAT_VEC4:                   return 4 * 4;
+        case GL_FLOAT_MAT3:                   return 4 * 3 * 3;
+        case GL_FLOAT_MAT4:                   return 4 * 4 * 4;
+        default:                              return 0;
+    }
+}
+
+static int cmp_uniform_shadow(const void *a, const void *b)
+{
+    const struct uniform_shadow *sa = a;
+    const struct uniform_shadow *sb = b;
+    return (sa->location > sb->location) - (sa->location < sb->location);
+}
+
+/*
+ * Uniforms of a type not uploaded by the nodes (such as images) have no
+ * shadow and are always uploaded.
+ */
+static int init_uniform_shadows(struct program_entry *e)
+{
+    struct hmap *uniforms = e->program.active_uniforms;
+
+    e->uniform_shadows = ngli_calloc(ngli_hmap_count(uniforms) + 1, sizeof(*e->uniform_shadows));
+    if (!e->uniform_shadows)
+        return -1;
+
+    int data_size = 0;
+    const struct hmap_entry *entry = NULL;
+    while ((entry = ngli_hmap_next(uniforms, entry))) {
+        const struct uniformprograminfo *info = entry->data;
+        const int size = get_uniform_type_size(info->type) * info->size;
+        if (info->location < 0 || !size)
+            continue;
+        struct uniform_shadow *shadow = &e->uniform_shadows[e->nb_uniform_shadows++];
+        shadow->location = info->location;
+        shadow->offset = data_size;
+        shadow->size = size;
+        data_size += size;
+    }
+    qsort(e->uniform_shadows, e->nb_uniform_shadows, sizeof(*e->uniform_shadows), cmp_uniform_shadow);
+
+    e->uniform_shadow_data = ngli_calloc(1, data_size + 1);
+    if (!e->uniform_shadow_data)
+        return -1;
+
+    return 0;
+}
+
+static struct uniform_shadow *get_uniform_shadow(struct program_entry *e, GLint location)
+{
+    int lo = 0;
+    int hi = e->nb_uniform_shadows - 1;
+    while (lo <= hi) {
+        const int mid = (lo + hi) / 2;
+        struct uniform_shadow *shadow = &e->uniform_shadows[mid];
+        if (shadow->location == location)
+            return shadow;
+        if (shadow->location < location)
+            lo = mid + 1;
+        else
+            hi = mid - 1;
+    }
+    return NULL;
+}
+
+void ngli_program_upload_uniform(struct glcontext *gl, struct program *program, GLint location,
+                                 GLenum type, int count, const void *data)
+{
+    struct program_entry *e = (struct program_entry *)program;
+
+    /*
+     * Only the values of the uploaded elements are compared: a partial upload
+     * of an array only updates these ones in the shadow, and a longer upload
+     * is never skipped since the elements past them hold no known value.
+     */
+    struct uniform_shadow *shadow = get_uniform_shadow(e, location);
+    const int size = get_uniform_type_size(type) * count;
+    if (shadow && size > shadow->size)
+        shadow = NULL;
+    if (shadow) {
+        uint8_t *shadow_data = e->uniform_shadow_data + shadow->offset;
+        if (size <= shadow->valid_size && !memcmp(shadow_data, data, size)) {
+            gl->uniform_stats.skipped++;
+            return;
+        }
+        memcpy(shadow_data, data, size);
+        shadow->valid_size = NGLI_MAX(shadow->valid_size, size);
+    }
+
+    gl->uniform_stats.issued++;
+    switch (type) {
+        case GL_FLOAT:      ngli_glUniform1fv(gl, location, count, data);                  break;
+        case GL_FLOAT_VEC2: ngli_glUniform2fv(gl, location, count, data);                  break;
+        case GL_FLOAT_VEC3: ngli_glUniform3fv(gl, location, count, data);                  break;
+        case GL_FLOAT_VEC4: ngli_glUniform4fv(gl, location, count, data);                  break;
+        case GL_INT:        ngli_glUniform1iv(gl, location, count, data);                  break;
+        case GL_FLOAT_MAT3: ngli_glUniformMatrix3fv(gl, location, count, GL_FALSE, data);  break;
+        case GL_FLOAT_MAT4: ngli_glUniformMatrix4fv(gl, location, count, GL_FALSE, data);  break;
+        default:
+            ngli_assert(0);
+    }
+}
+
+struct program *ngli_program_get(struct ngl_ctx *s, const char *label, const char *vertex,
+                                 const char *fragment, const char *compute)
+{
+    const char *sources[NB_SHADERS] = {vertex, fragment, compute};
+    char key[KEY_LEN];
+    get_key(key, sources);
+
+    struct program_entry *e = get_registered(s, key, sources);
+    if (e) {
+        e->refcount++;
+        return &e->program;
+    }
+
+    e = ngli_calloc(1, sizeof(*e));
+    if (!e)
+        return NULL;
+    memcpy(e->key, key, sizeof(key));
+    e->refcount = 1;
+
+    struct program *program = &e->program;
+    for (int i = 0; i < NB_SHADERS; i++) {
+        if (sources[i] && !(e->sources[i] = ngli_strdup(sources[i])))
+            goto fail;
+    }
+
+    program->id = build_program(s, key, sources);
+    if (!program->id)
         goto fail;
 
-    ngli_glShaderSource(gl, fragment_shader, 1, &fragment, NULL);
-    ngli_glCompileShader(gl, fragment_shader);
-    if (ngli_program_check_status(gl, fragment_shader, GL_COMPILE_STATUS) < 0)
+    if (probe_program(program, label, s->glcontext, vertex != NULL) < 0 ||
+        init_uniform_shadows(e) < 0)
         goto fail;
 
-    ngli_glAttachShader(gl, program, vertex_shader);
-    ngli_glAttachShader(gl, program, fragment_shader);
-    ngli_glLinkProgram(gl, program);
-    if (ngli_program_check_status(gl, program, GL_LINK_STATUS) < 0)
+    if (!s->programs && !(s->programs = ngli_hmap_create()))
         goto fail;
 
-    ngli_glDeleteShader(gl, vertex_shader);
-    ngli_glDeleteShader(gl, fragment_shader);
+    /*
+     * A key collision between different shaders is very unlikely: the
+     * program is then simply not shared.
+     */
+    if (!ngli_hmap_get(s->programs, key)) {
+        if (ngli_hmap_set(s->programs, key, e) < 0)
+            goto fail;
+        e->registered = 1;
+    }
 
     return program;
 
 fail:
-    if (vertex_shader)
-        ngli_glDeleteShader(gl, vertex_shader);
-    if (fragment_shader)
-        ngli_glDeleteShader(gl, fragment_shader);
-    if (program)
-        ngli_glDeleteProgram(gl, program);
+    ngli_program_unrefp(s, &program);
+    return NULL;
+}
 
-    return 0;
+void ngli_program_unrefp(struct ngl_ctx *s, struct program **programp)
+{
+    struct program *program = *programp;
+    if (!program)
+        return;
+    *programp = NULL;
+
+    struct program_entry *e = (struct program_entry *)program;
+    if (--e->refcount)
+        return;
+
+    if (e->registered)
+        ngli_hmap_set(s->programs, e->key, NULL);
+    ngli_hmap_freep(&program->active_uniforms);
+    ngli_hmap_freep(&program->active_attributes);
+    ngli_hmap_freep(&program->active_buffer_blocks);
+    if (program->id)
+        ngli_glDeleteProgram(s->glcontext, program->id);
+    for (int i = 0; i < NB_SHADERS; i++)
+        ngli_free(e->sources[i]);
+    ngli_free(e->uniform_shadows);
+    ngli_free(e->uniform_shadow_data);
+    ngli_free(e);
 }
 
 int ngli_program_check_status(const struct glcontext *gl, GLuint id, GLenum status)
@@ -142,6 +660,15 @@ struct hmap *ngli_program_probe_uniforms(const char *node_label, struct glcontex
             info->binding = -1;
         }
 
+        info->block_index = -1;
+        if (gl->features & NGLI_FEATURE_UNIFORM_BUFFER_OBJECT) {
+            const GLuint index = i;
+            ngli_glGetActiveUniformsiv(gl, pid, 1, &index, GL_UNIFORM_BLOCK_INDEX, &info->block_index);
+            ngli_glGetActiveUniformsiv(gl, pid, 1, &index, GL_UNIFORM_OFFSET, &info->offset);
+            ngli_glGetActiveUniformsiv(gl, pid, 1, &index, GL_UNIFORM_ARRAY_STRIDE, &info->array_stride);
+            ngli_glGetActiveUniformsiv(gl, pid, 1, &index, GL_UNIFORM_MATRIX_STRIDE, &info->matrix_stride);
+        }
+
         LOG(DEBUG, "%s.uniform[%d/%d]: %s location:%d size=%d type=0x%x binding=%d", node_label,
             i + 1, nb_active_uniforms, name, info->location, info->size, info->type, info->binding);
 
@@ -213,7 +740,9 @@ struct hmap *ngli_program_probe_buffer_blocks(const char *node_label, struct glc
         ngli_glGetActiveUniformBlockName(gl, pid, i, sizeof(name), NULL, name);
         GLuint block_index = ngli_glGetUniformBlockIndex(gl, pid, name);
         ngli_glGetActiveUniformBlockiv(gl, pid, block_index, GL_UNIFORM_BLOCK_BINDING, &info->binding);
+        ngli_glGetActiveUniformBlockiv(gl, pid, block_index, GL_UNIFORM_BLOCK_DATA_SIZE, &info->data_size);
         ngli_glUniformBlockBinding(gl, pid, block_index, info->binding);
+        info->block_index = block_index;
 
         LOG(DEBUG, "%s.ubo[%d/%d]: %s binding:%d",
             node_label, i + 1, nb_active_uniform_buffers, name, info->binding);
@@ -241,6 +770,7 @@ struct hmap *ngli_program_probe_buffer_blocks(const char *node_label, struct glc
             return NULL;
         }
         info->type = GL_SHADER_STORAGE_BUFFER;
+        info->data_size = 0;
 
         ngli_glGetProgramResourceName(gl, pid, GL_SHADER_STORAGE_BLOCK, i, sizeof(name), NULL, name);
         GLuint block_index = ngli_glGetProgramResourceIndex(gl, pid, GL_SHADER_STORAGE_BLOCK, name);
@@ -248,6 +778,7 @@ struct hmap *ngli_program_probe_buffer_blocks(const char *node_label, struct glc
         static const GLenum props[] = {GL_BUFFER_BINDING};
         ngli_glGetProgramResourceiv(gl, pid, GL_SHADER_STORAGE_BLOCK, block_index,
                                     NGLI_ARRAY_NB(props), props, 1, NULL, &info->binding);
+        info->block_index = block_index;
 
         LOG(DEBUG, "%s.ssbo[%d/%d]: %s binding:%d",
             node_label, i + 1, nb_active_buffers, name, info->binding);
@@ -25,7 +25,52 @@
 #include "hmap.h"
 #include "glcontext.h"
 
+struct ngl_ctx;
+
 GLuint ngli_program_load(struct glcontext *gl, const char *vertex, const char *fragment);
+
+/*
+ * Program shared by the nodes of a context with the same shaders
+ */
+struct program {
+    GLuint id;
+    struct hmap *active_uniforms;
+    struct hmap *active_attributes; /* NULL for compute programs */
+    struct hmap *active_buffer_blocks;
+};
+
+/*
+ * Start the build (compilation and link) of a program before it is needed
+ * by ngli_program_get() (typically while pre-initializing a node), without
+ * waiting for it. Either the vertex and fragment shaders or the compute
+ * shader are set, the others are NULL. The sources must stay valid until the
+ * build is claimed. If the context has a program cache, the program is
+ * loaded from its cached binary when possible, and its binary is stored in
+ * the cache otherwise.
+ */
+int ngli_program_build_start(struct ngl_ctx *s, const char *vertex, const char *fragment,
+                             const char *compute);
+
+/* Discard the builds which have not been claimed by ngli_program_get() */
+void ngli_program_build_reset(struct ngl_ctx *s);
+
+/*
+ * Get a reference to the program of the context with the given shaders,
+ * built (or its started build completed) and probed if no other node holds
+ * it yet. The label is only used for logging.
+ */
+struct program *ngli_program_get(struct ngl_ctx *s, const char *label, const char *vertex,
+                                 const char *fragment, const char *compute);
+void ngli_program_unrefp(struct ngl_ctx *s, struct program **programp);
+
+/*
+ * Upload count values of the given type (GL_FLOAT, GL_FLOAT_VEC2/3/4, GL_INT,
+ * GL_FLOAT_MAT3 or GL_FLOAT_MAT4) to the uniform at location of the program
+ * currently in use, unless the program already holds the exact same values.
+ */
+void ngli_program_upload_uniform(struct glcontext *gl, struct program *program, GLint location,
+                                 GLenum type, int count, const void *data);
+
 int ngli_program_check_status(const struct glcontext *gl, GLuint id, GLenum status);
 struct hmap *ngli_program_probe_uniforms(const char *node_label, struct glcontext *gl, GLuint pid);
 struct hmap *ngli_program_probe_attributes(const char *node_label, struct glcontext *gl, GLuint pid);
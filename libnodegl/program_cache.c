@@ -0,0 +1,305 @@
+/*
+ * Copyright 2018 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#define _POSIX_C_SOURCE 200809L // mkstemp(), fdopen()
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "log.h"
+#include "memory.h"
+#include "program_cache.h"
+#include "utils.h"
+
+#define CACHE_VERSION 2
+#define MAX_BINARY_SIZE (64 << 20)
+
+struct program_cache {
+    char *dir;
+    char *driver_id;
+    struct ngl_program_cache_stats stats;
+};
+
+/*
+ * Entries are only shared between contexts of the same machine so the header
+ * is stored in the native layout. It is followed by the identity of the
+ * program (see get_identity()), then by the binary.
+ */
+struct entry_header {
+    char magic[4];
+    uint32_t version;
+    uint64_t key;
+    uint32_t identity_size;
+    uint32_t format;
+    uint32_t size;
+};
+
+static const char entry_magic[4] = {'N', 'G', 'L', 'P'};
+
+struct program_cache *ngli_program_cache_create(const char *dir, const char *driver_id)
+{
+    struct program_cache *s = ngli_calloc(1, sizeof(*s));
+    if (!s)
+        return NULL;
+    s->dir = ngli_strdup(dir);
+    s->driver_id = ngli_strdup(driver_id);
+    if (!s->dir || !s->driver_id) {
+        ngli_program_cache_freep(&s);
+        return NULL;
+    }
+    return s;
+}
+
+/* 64-bit FNV-1a */
+static uint64_t hash_update(uint64_t hash, const char *data, size_t size)
+{
+    for (size_t i = 0; i < size; i++) {
+        hash ^= (uint8_t)data[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+/*
+ * The identity of a program is the driver id followed by the sources. It
+ * includes the terminating nul of every string so the concatenation of the
+ * sources is not ambiguous, and a presence byte for each stage so a missing
+ * stage differs from an empty one. It is stored in the entries and compared
+ * on read, the key (its hash) only naming the entry file.
+ */
+static char *get_identity(const struct program_cache *s, const char * const *sources, int nb_sources,
+                          uint32_t *sizep)
+{
+    size_t size = strlen(s->driver_id) + 1;
+    for (int i = 0; i < nb_sources; i++)
+        size += 1 + (sources[i] ? strlen(sources[i]) + 1 : 0);
+    if (size > MAX_BINARY_SIZE)
+        return NULL;
+
+    char *identity = ngli_malloc(size);
+    if (!identity)
+        return NULL;
+
+    char *p = identity;
+    const size_t driver_id_size = strlen(s->driver_id) + 1;
+    memcpy(p, s->driver_id, driver_id_size);
+    p += driver_id_size;
+    for (int i = 0; i < nb_sources; i++) {
+        const char *source = sources[i];
+        *p++ = source != NULL;
+        if (source) {
+            const size_t source_size = strlen(source) + 1;
+            memcpy(p, source, source_size);
+            p += source_size;
+        }
+    }
+
+    *sizep = size;
+    return identity;
+}
+
+static uint64_t get_key(const char *identity, uint32_t identity_size)
+{
+    return hash_update(0xcbf29ce484222325ULL, identity, identity_size);
+}
+
+static char *get_entry_path(const struct program_cache *s, uint64_t key, const char *suffix)
+{
+    return ngli_asprintf("%s/%016" PRIx64 "%s", s->dir, key, suffix);
+}
+
+int ngli_program_cache_read(struct program_cache *s, const char * const *sources, int nb_sources,
+                            uint32_t *format, void **datap, int *sizep)
+{
+    uint32_t identity_size;
+    char *identity = get_identity(s, sources, nb_sources, &identity_size);
+    if (!identity)
+        return -1;
+
+    const uint64_t key = get_key(identity, identity_size);
+    char *path = get_entry_path(s, key, ".bin");
+    if (!path) {
+        ngli_free(identity);
+        return -1;
+    }
+
+    int ret = 0;
+    void *data = NULL;
+    char *entry_identity = NULL;
+    FILE *fp = fopen(path, "rb");
+    if (!fp) {
+        s->stats.misses++;
+        goto end;
+    }
+
+    struct entry_header header;
+    if (fread(&header, sizeof(header), 1, fp) != 1 ||
+        memcmp(header.magic, entry_magic, sizeof(entry_magic)) ||
+        header.version != CACHE_VERSION ||
+        header.key != key ||
+        !header.size || header.size > MAX_BINARY_SIZE)
+        goto corrupted;
+
+    /* Another program with the same key: this is not the entry we are looking for */
+    if (header.identity_size != identity_size) {
+        s->stats.misses++;
+        goto end;
+    }
+
+    entry_identity = ngli_malloc(identity_size);
+    data = ngli_malloc(header.size);
+    if (!entry_identity || !data) {
+        ret = -1;
+        goto end;
+    }
+
+    if (fread(entry_identity, identity_size, 1, fp) != 1)
+        goto corrupted;
+
+    if (memcmp(entry_identity, identity, identity_size)) {
+        s->stats.misses++;
+        goto end;
+    }
+
+    char trailing;
+    if (fread(data, header.size, 1, fp) != 1 || fread(&trailing, 1, 1, fp))
+        goto corrupted;
+
+    *format = header.format;
+    *datap = data;
+    *sizep = header.size;
+    data = NULL;
+    ret = 1;
+    goto end;
+
+corrupted:
+    LOG(WARNING, "ignoring corrupted program cache entry %s", path);
+    s->stats.stale++;
+
+end:
+    if (fp)
+        fclose(fp);
+    ngli_free(data);
+    ngli_free(entry_identity);
+    ngli_free(identity);
+    ngli_free(path);
+    return ret;
+}
+
+void ngli_program_cache_validate(struct program_cache *s, int accepted)
+{
+    if (accepted)
+        s->stats.hits++;
+    else
+        s->stats.stale++;
+}
+
+/*
+ * The entry is written in a temporary file with a unique name, renamed once
+ * complete, so a concurrent reader or writer (such as another process sharing
+ * the directory) never finds a partial entry.
+ */
+int ngli_program_cache_write(struct program_cache *s, const char * const *sources, int nb_sources,
+                             uint32_t format, const void *data, int size)
+{
+    if (size <= 0 || size > MAX_BINARY_SIZE)
+        return -1;
+
+    uint32_t identity_size;
+    char *identity = get_identity(s, sources, nb_sources, &identity_size);
+    if (!identity)
+        return -1;
+
+    const uint64_t key = get_key(identity, identity_size);
+    char *tmp_path = get_entry_path(s, key, ".XXXXXX");
+    char *path = get_entry_path(s, key, ".bin");
+    if (!tmp_path || !path) {
+        ngli_free(identity);
+        ngli_free(tmp_path);
+        ngli_free(path);
+        return -1;
+    }
+
+    int ret = -1;
+    FILE *fp = NULL;
+    const int fd = mkstemp(tmp_path);
+    if (fd < 0 || !(fp = fdopen(fd, "wb"))) {
+        LOG(WARNING, "could not create program cache entry %s", tmp_path);
+        if (fd >= 0) {
+            close(fd);
+            remove(tmp_path);
+        }
+        goto end;
+    }
+
+    struct entry_header header = {
+        .version       = CACHE_VERSION,
+        .key           = key,
+        .identity_size = identity_size,
+        .format        = format,
+        .size          = size,
+    };
+    memcpy(header.magic, entry_magic, sizeof(entry_magic));
+
+    const int written = fwrite(&header, sizeof(header), 1, fp) == 1 &&
+                        fwrite(identity, identity_size, 1, fp) == 1 &&
+                        fwrite(data, size, 1, fp) == 1;
+    if (fclose(fp) || !written) {
+        LOG(WARNING, "could not write program cache entry %s", tmp_path);
+        remove(tmp_path);
+        goto end;
+    }
+
+    /* rename() does not replace an existing file on all platforms */
+    remove(path);
+    if (rename(tmp_path, path)) {
+        LOG(WARNING, "could not rename program cache entry %s to %s", tmp_path, path);
+        remove(tmp_path);
+        goto end;
+    }
+
+    ret = 0;
+
+end:
+    ngli_free(identity);
+    ngli_free(tmp_path);
+    ngli_free(path);
+    return ret;
+}
+
+void ngli_program_cache_get_stats(const struct program_cache *s, struct ngl_program_cache_stats *stats)
+{
+    *stats = s->stats;
+}
+
+void ngli_program_cache_freep(struct program_cache **sp)
+{
+    struct program_cache *s = *sp;
+    if (!s)
+        return;
+    ngli_free(s->dir);
+    ngli_free(s->driver_id);
+    ngli_free(s);
+    *sp = NULL;
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright 2018 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#ifndef PROGRAM_CACHE_H
+#define PROGRAM_CACHE_H
+
+#include <stdint.h>
+
+#include "nodegl.h"
+
+struct program_cache;
+
+/*
+ * On-disk cache of program binaries in the directory dir. The driver_id
+ * identifies the driver (vendor, renderer, version) the binaries have been
+ * retrieved from, as they are only valid for that one.
+ */
+struct program_cache *ngli_program_cache_create(const char *dir, const char *driver_id);
+
+/*
+ * Read the binary of the program built from the given shader sources (NULL
+ * for missing stages). Returns 1 and sets the binary format and the data
+ * (which must be freed with ngli_free()) if an entry has been found, 0 if
+ * there is none (or a corrupted one) and < 0 on error.
+ */
+int ngli_program_cache_read(struct program_cache *s, const char * const *sources, int nb_sources,
+                            uint32_t *format, void **datap, int *sizep);
+
+/*
+ * Account whether the driver accepted the binary returned by the last
+ * successful read. A rejected entry (typically after a driver update) is
+ * counted as stale and is expected to be overwritten.
+ */
+void ngli_program_cache_validate(struct program_cache *s, int accepted);
+
+int ngli_program_cache_write(struct program_cache *s, const char * const *sources, int nb_sources,
+                             uint32_t format, const void *data, int size);
+
+void ngli_program_cache_get_stats(const struct program_cache *s, struct ngl_program_cache_stats *stats);
+void ngli_program_cache_freep(struct program_cache **sp);
+
+#endif /* PROGRAM_CACHE_H */
@@ -0,0 +1,181 @@
+/*
+ * Copyright 2018 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#include <pthread.h>
+
+#include "glbindings.h"
+#include "utils.h"
+
+static void check_stats(const struct glbindings *s, int64_t issued, int64_t elided)
+{
+    struct ngl_binding_stats stats;
+    ngli_glbindings_get_stats(s, &stats);
+    ngli_assert(stats.issued == issued);
+    ngli_assert(stats.elided == elided);
+}
+
+/*
+ * A context sharing the objects of the main one, current on its own thread,
+ * such as the one of the prefetcher
+ */
+struct shared_ctx {
+    struct glbindings *bindings;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    int step;
+};
+
+static void wait_step(struct shared_ctx *s, int step)
+{
+    pthread_mutex_lock(&s->lock);
+    while (s->step < step)
+        pthread_cond_wait(&s->cond, &s->lock);
+    pthread_mutex_unlock(&s->lock);
+}
+
+static void set_step(struct shared_ctx *s, int step)
+{
+    pthread_mutex_lock(&s->lock);
+    s->step = step;
+    pthread_cond_broadcast(&s->cond);
+    pthread_mutex_unlock(&s->lock);
+}
+
+static void *shared_ctx_thread(void *arg)
+{
+    struct shared_ctx *s = arg;
+    ngli_glbindings_set_current(s->bindings);
+
+    ngli_assert(ngli_glbindings_active_texture(GL_TEXTURE0));
+    ngli_assert(ngli_glbindings_bind_texture(GL_TEXTURE_2D, 9));
+    set_step(s, 1);
+
+    /*
+     * The texture has been deleted from the main context and its name
+     * reused: the shadow of this context still has it bound until it is
+     * invalidated.
+     */
+    wait_step(s, 2);
+    ngli_assert(!ngli_glbindings_bind_texture(GL_TEXTURE_2D, 9));
+    ngli_glbindings_invalidate();
+    ngli_assert(ngli_glbindings_active_texture(GL_TEXTURE0));
+    ngli_assert(ngli_glbindings_bind_texture(GL_TEXTURE_2D, 9));
+
+    ngli_glbindings_set_current(NULL);
+    return NULL;
+}
+
+static void test_shared_ctx(void)
+{
+    struct shared_ctx s = {.bindings = ngli_glbindings_create()};
+    ngli_assert(s.bindings);
+    ngli_assert(!pthread_mutex_init(&s.lock, NULL));
+    ngli_assert(!pthread_cond_init(&s.cond, NULL));
+
+    pthread_t tid;
+    ngli_assert(!pthread_create(&tid, NULL, shared_ctx_thread, &s));
+
+    wait_step(&s, 1);
+    const GLuint texture = 9;
+    ngli_glbindings_delete_textures(1, &texture);
+    ngli_assert(ngli_glbindings_bind_texture(GL_TEXTURE_2D, 9));
+    set_step(&s, 2);
+
+    pthread_join(tid, NULL);
+    check_stats(s.bindings, 4, 1);
+
+    pthread_cond_destroy(&s.cond);
+    pthread_mutex_destroy(&s.lock);
+    ngli_glbindings_freep(&s.bindings);
+}
+
+int main(void)
+{
+    /* Without current shadow, every call is issued */
+    ngli_assert(ngli_glbindings_use_program(1));
+    ngli_assert(ngli_glbindings_use_program(1));
+
+    struct glbindings *s = ngli_glbindings_create();
+    ngli_assert(s);
+    ngli_glbindings_set_current(s);
+
+    ngli_assert(ngli_glbindings_use_program(1));
+    ngli_assert(!ngli_glbindings_use_program(1));
+    ngli_assert(ngli_glbindings_use_program(2));
+    check_stats(s, 2, 1);
+
+    /* Textures are tracked per unit and per target */
+    ngli_assert(ngli_glbindings_active_texture(GL_TEXTURE0));
+    ngli_assert(ngli_glbindings_bind_texture(GL_TEXTURE_2D, 3));
+    ngli_assert(!ngli_glbindings_bind_texture(GL_TEXTURE_2D, 3));
+    ngli_assert(ngli_glbindings_bind_texture(GL_TEXTURE_EXTERNAL_OES, 3));
+    ngli_assert(ngli_glbindings_active_texture(GL_TEXTURE1));
+    ngli_assert(ngli_glbindings_bind_texture(GL_TEXTURE_2D, 3));
+    ngli_assert(ngli_glbindings_active_texture(GL_TEXTURE0));
+    ngli_assert(!ngli_glbindings_bind_texture(GL_TEXTURE_2D, 3));
+
+    /* A deleted texture is unbound and its name may be reused */
+    const GLuint texture = 3;
+    ngli_glbindings_delete_textures(1, &texture);
+    ngli_assert(ngli_glbindings_bind_texture(GL_TEXTURE_2D, 3));
+
+    /* The element array buffer binding belongs to the vertex array */
+    ngli_assert(ngli_glbindings_bind_vertex_array(1));
+    ngli_assert(ngli_glbindings_bind_buffer(GL_ELEMENT_ARRAY_BUFFER, 4));
+    ngli_assert(!ngli_glbindings_bind_buffer(GL_ELEMENT_ARRAY_BUFFER, 4));
+    ngli_assert(ngli_glbindings_bind_vertex_array(2));
+    ngli_assert(ngli_glbindings_bind_buffer(GL_ELEMENT_ARRAY_BUFFER, 4));
+
+    /* Indexed bindings also bind the generic binding point */
+    ngli_assert(ngli_glbindings_bind_buffer_base(GL_UNIFORM_BUFFER, 0, 5));
+    ngli_assert(!ngli_glbindings_bind_buffer_base(GL_UNIFORM_BUFFER, 0, 5));
+    ngli_assert(!ngli_glbindings_bind_buffer(GL_UNIFORM_BUFFER, 5));
+    ngli_assert(ngli_glbindings_bind_buffer(GL_UNIFORM_BUFFER, 6));
+    ngli_assert(ngli_glbindings_bind_buffer_base(GL_UNIFORM_BUFFER, 0, 5));
+
+    /* GL_FRAMEBUFFER binds both the read and draw framebuffers */
+    ngli_assert(ngli_glbindings_bind_framebuffer(GL_FRAMEBUFFER, 7));
+    ngli_assert(!ngli_glbindings_bind_framebuffer(GL_READ_FRAMEBUFFER, 7));
+    ngli_assert(ngli_glbindings_bind_framebuffer(GL_DRAW_FRAMEBUFFER, 8));
+    ngli_assert(ngli_glbindings_bind_framebuffer(GL_FRAMEBUFFER, 7));
+
+    ngli_assert(ngli_glbindings_viewport(0, 0, 640, 480));
+    ngli_assert(!ngli_glbindings_viewport(0, 0, 640, 480));
+    ngli_assert(ngli_glbindings_viewport(0, 0, 320, 240));
+
+    /* Everything is issued again once invalidated */
+    ngli_glbindings_invalidate();
+    ngli_assert(ngli_glbindings_use_program(2));
+    ngli_assert(ngli_glbindings_viewport(0, 0, 320, 240));
+
+    check_stats(s, 23, 8);
+
+    /* Deletions only reach the shadow of the current context */
+    test_shared_ctx();
+    check_stats(s, 24, 8);
+
+    ngli_glbindings_freep(&s);
+    ngli_assert(!s);
+    ngli_assert(ngli_glbindings_use_program(2));
+
+    return 0;
+}
@@ -0,0 +1,119 @@
+/*
+ * Copyright 2018 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#include <stdio.h>
+#include <string.h>
+
+#include "instancing.h"
+#include "utils.h"
+
+static const char *vertex =
+    "#version 100\n"
+    "precision highp float;\n"
+    "attribute vec4 ngl_position;\n"
+    "uniform mat4 ngl_modelview_matrix;\n"
+    "uniform mat4 ngl_projection_matrix;\n"
+    "uniform mediump float scale;\n"
+    "void main()\n"
+    "{\n"
+    "    gl_Position = ngl_projection_matrix * ngl_modelview_matrix * (ngl_position * scale);\n"
+    "}\n";
+
+static const char *fragment =
+    "#version 100\n"
+    "precision mediump float;\n"
+    "uniform vec4 color;\n"
+    "uniform float opacity;\n"
+    "void main()\n"
+    "{\n"
+    "    gl_FragColor = color * opacity;\n"
+    "}\n";
+
+#define CHECK_STR(s, str) ngli_assert(strstr(s, str))
+
+int main(void)
+{
+    struct instancing_var vars[] = {
+        {"scale",   "float"},
+        {"color",   "vec4"},
+        {"unused",  "vec2"},
+    };
+    struct instancing_shaders s;
+
+    int ret = ngli_instancing_rewrite(&s, vertex, fragment, vars, NGLI_ARRAY_NB(vars));
+    ngli_assert(ret == 0);
+    printf("%s\n%s\n", s.vertex, s.fragment);
+
+    ngli_assert(s.has_modelview && !s.has_normal);
+    ngli_assert(vars[0].used && vars[1].used && !vars[2].used);
+
+    CHECK_STR(s.vertex, "\nmat4 ngl_modelview_matrix;\n");
+    CHECK_STR(s.vertex, "uniform mat4 ngl_projection_matrix;\n");
+    CHECK_STR(s.vertex, "\nmediump float scale;\n");
+    CHECK_STR(s.vertex, "varying vec4 color;\n");
+    CHECK_STR(s.vertex, "attribute vec4 ngli_instance_modelview_3;\n");
+    CHECK_STR(s.vertex, "attribute float ngli_instance_scale;\n");
+    CHECK_STR(s.vertex, "attribute vec4 ngli_instance_color;\n");
+    CHECK_STR(s.vertex, "void ngli_main()\n");
+    CHECK_STR(s.vertex, "    color = ngli_instance_color;\n");
+    ngli_assert(!strstr(s.vertex, "unused"));
+    CHECK_STR(s.fragment, "\nvarying vec4 color;\n");
+    CHECK_STR(s.fragment, "uniform float opacity;\n");
+    ngli_instancing_reset(&s);
+
+    /* GLSL 3.00 qualifiers */
+    static const char *vertex_300 =
+        "#version 300 es\n"
+        "in vec4 ngl_position;\n"
+        "uniform mat4 ngl_modelview_matrix;\n"
+        "uniform mat4 ngl_projection_matrix;\n"
+        "uniform mat3 ngl_normal_matrix;\n"
+        "out vec3 normal;\n"
+        "void main() { normal = ngl_normal_matrix * vec3(0.0, 0.0, 1.0); gl_Position = ngl_projection_matrix * ngl_modelview_matrix * ngl_position; }\n";
+    static const char *fragment_300 =
+        "#version 300 es\n"
+        "precision mediump float;\n"
+        "uniform highp vec4 color;\n"
+        "in vec3 normal;\n"
+        "out vec4 frag_color;\n"
+        "void main() { frag_color = color * normal.z; }\n";
+    ret = ngli_instancing_rewrite(&s, vertex_300, fragment_300, vars, NGLI_ARRAY_NB(vars));
+    ngli_assert(ret == 0);
+    ngli_assert(s.has_modelview && s.has_normal);
+    CHECK_STR(s.vertex, "in vec3 ngli_instance_normal_2;\n");
+    CHECK_STR(s.vertex, "out highp vec4 color;\n");
+    CHECK_STR(s.fragment, "\nin highp vec4 color;\n");
+    ngli_instancing_reset(&s);
+
+    /* Unsupported shaders */
+    static const char *fragment_modelview =
+        "uniform mat4 ngl_modelview_matrix;\n"
+        "void main() { gl_FragColor = ngl_modelview_matrix[0]; }\n";
+    ret = ngli_instancing_rewrite(&s, vertex, fragment_modelview, NULL, 0);
+    ngli_assert(ret == 1 && !s.vertex && !s.fragment);
+
+    struct instancing_var bad_type[] = {{"color", "vec3"}};
+    ret = ngli_instancing_rewrite(&s, vertex, fragment, bad_type, NGLI_ARRAY_NB(bad_type));
+    ngli_assert(ret == 1);
+
+    return 0;
+}
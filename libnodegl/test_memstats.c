@@ -0,0 +1,73 @@
+/*
+ * Copyright 2018 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#include <string.h>
+
+#include "memstats.h"
+#include "utils.h"
+
+int main(void)
+{
+    struct ngl_memory_stats ctx_stats = {0};
+    struct ngl_memory_stats node_stats = {0};
+    struct ngl_memory_stats stats;
+    struct memstats_entry a = {0}, b = {0}, c = {0};
+
+    /* Without owner, only the context statistics are updated */
+    ngli_memstats_add(&a, &ctx_stats, NGL_MEMORY_BUFFERS, 1024);
+    ngli_assert(ctx_stats.sizes[NGL_MEMORY_BUFFERS] == 1024);
+    ngli_assert(ctx_stats.counts[NGL_MEMORY_BUFFERS] == 1);
+    ngli_assert(!a.node_stats);
+
+    struct ngl_memory_stats *prev = ngli_memstats_set_owner(&node_stats);
+    ngli_assert(!prev);
+    ngli_memstats_add(&b, &ctx_stats, NGL_MEMORY_TEXTURES, 4096);
+    ngli_memstats_add(&c, &ctx_stats, NGL_MEMORY_BUFFERS, 512);
+    prev = ngli_memstats_set_owner(prev);
+    ngli_assert(prev == &node_stats);
+
+    ngli_memstats_copy(&stats, &ctx_stats);
+    ngli_assert(stats.sizes[NGL_MEMORY_BUFFERS] == 1024 + 512);
+    ngli_assert(stats.counts[NGL_MEMORY_BUFFERS] == 2);
+    ngli_assert(stats.sizes[NGL_MEMORY_TEXTURES] == 4096);
+    ngli_assert(stats.counts[NGL_MEMORY_TEXTURES] == 1);
+
+    ngli_memstats_copy(&stats, &node_stats);
+    ngli_assert(stats.sizes[NGL_MEMORY_BUFFERS] == 512);
+    ngli_assert(stats.sizes[NGL_MEMORY_TEXTURES] == 4096);
+
+    /* The entries are removed from the statistics they were added to */
+    ngli_memstats_remove(&c);
+    ngli_memstats_remove(&c);
+    ngli_assert(ctx_stats.sizes[NGL_MEMORY_BUFFERS] == 1024);
+    ngli_assert(node_stats.sizes[NGL_MEMORY_BUFFERS] == 0);
+    ngli_assert(node_stats.counts[NGL_MEMORY_BUFFERS] == 0);
+
+    ngli_memstats_remove(&a);
+    ngli_memstats_remove(&b);
+
+    const struct ngl_memory_stats zero = {0};
+    ngli_assert(!memcmp(&ctx_stats, &zero, sizeof(zero)));
+    ngli_assert(!memcmp(&node_stats, &zero, sizeof(zero)));
+
+    return 0;
+}
@@ -0,0 +1,143 @@
+/*
+ * Copyright 2018 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "nodegl.h"
+#include "nodes.h"
+#include "utils.h"
+
+#define NB_THREADS 8
+#define NB_NODES_PER_THREAD 12500 /* 100k nodes in total */
+
+struct build_arg {
+    struct ngl_node *shared;
+    struct ngl_node *subtree;
+    char *serialized;
+};
+
+/*
+ * Build a subtree of NB_NODES_PER_THREAD nodes, all of them but the root
+ * referencing the node shared by every thread.
+ */
+static void *build_subtree(void *user_arg)
+{
+    struct build_arg *arg = user_arg;
+
+    struct ngl_node *group = ngl_node_create(NGL_NODE_GROUP);
+    ngli_assert(group);
+
+    for (int i = 0; i < NB_NODES_PER_THREAD - 1; i++) {
+        struct ngl_node *translate = ngl_node_create(NGL_NODE_TRANSLATE, arg->shared);
+        ngli_assert(translate);
+        const float vector[3] = {i, 0.f, 0.f};
+        int ret = ngl_node_param_set(translate, "vector", vector);
+        ngli_assert(ret == 0);
+        ret = ngl_node_param_add(group, "children", 1, &translate);
+        ngli_assert(ret == 0);
+        ngl_node_unrefp(&translate);
+    }
+
+    arg->subtree = group;
+    return NULL;
+}
+
+static void check_deserialize(struct build_arg *arg, struct ngl_arena *arena)
+{
+    struct ngl_node *subtree = arena ? ngl_node_deserialize_arena(arena, arg->serialized)
+                                     : ngl_node_deserialize(arg->serialized);
+    ngli_assert(subtree);
+    ngli_assert(subtree->arena == arena);
+    char *serialized = ngl_node_serialize(subtree);
+    ngli_assert(serialized && !strcmp(serialized, arg->serialized));
+    free(serialized);
+    ngl_node_unrefp(&subtree);
+}
+
+static void *deserialize_subtree(void *user_arg)
+{
+    struct build_arg *arg = user_arg;
+
+    check_deserialize(arg, NULL);
+
+    /* The nodes keep the arena alive after the caller released it */
+    struct ngl_arena *arena = ngl_arena_create();
+    ngli_assert(arena);
+    struct ngl_node *group = ngl_node_create_arena(arena, NGL_NODE_GROUP);
+    ngli_assert(group && group->arena == arena);
+    check_deserialize(arg, arena);
+    ngl_arena_unrefp(&arena);
+    ngli_assert(!arena);
+    int ret = ngl_node_param_add(group, "children", 1, &arg->shared);
+    ngli_assert(ret == 0);
+    ngl_node_unrefp(&group);
+    return NULL;
+}
+
+static void run_threads(void *(*func)(void *), struct build_arg *args)
+{
+    pthread_t threads[NB_THREADS];
+    for (int i = 0; i < NB_THREADS; i++) {
+        int ret = pthread_create(&threads[i], NULL, func, &args[i]);
+        ngli_assert(ret == 0);
+    }
+    for (int i = 0; i < NB_THREADS; i++)
+        pthread_join(threads[i], NULL);
+}
+
+int main(void)
+{
+    ngl_log_set_min_level(NGL_LOG_ERROR);
+
+    struct ngl_node *shared = ngl_node_create(NGL_NODE_GROUP);
+    ngli_assert(shared);
+
+    struct build_arg args[NB_THREADS] = {0};
+    for (int i = 0; i < NB_THREADS; i++)
+        args[i].shared = shared;
+    run_threads(build_subtree, args);
+
+    ngli_assert(shared->refcount == 1 + NB_THREADS * (NB_NODES_PER_THREAD - 1));
+
+    /* Join the subtrees built in parallel */
+    struct ngl_node *root = ngl_node_create(NGL_NODE_GROUP);
+    ngli_assert(root);
+    for (int i = 0; i < NB_THREADS; i++) {
+        int ret = ngl_node_param_add(root, "children", 1, &args[i].subtree);
+        ngli_assert(ret == 0);
+        args[i].serialized = ngl_node_serialize(args[i].subtree);
+        ngli_assert(args[i].serialized);
+        ngl_node_unrefp(&args[i].subtree);
+    }
+
+    run_threads(deserialize_subtree, args);
+    for (int i = 0; i < NB_THREADS; i++)
+        free(args[i].serialized);
+
+    ngl_node_unrefp(&root);
+    ngli_assert(shared->refcount == 1);
+    ngl_node_unrefp(&shared);
+
+    return 0;
+}
@@ -0,0 +1,166 @@
+/*
+ * Copyright 2018 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#include <dirent.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "memory.h"
+#include "program_cache.h"
+#include "utils.h"
+
+static const char *sources[] = {"vertex", "fragment", NULL};
+static const char binary[] = "program binary";
+
+static void check_stats(const struct program_cache *cache, int hits, int misses, int stale)
+{
+    struct ngl_program_cache_stats stats;
+    ngli_program_cache_get_stats(cache, &stats);
+    ngli_assert(stats.hits == hits);
+    ngli_assert(stats.misses == misses);
+    ngli_assert(stats.stale == stale);
+}
+
+static int read_entry(struct program_cache *cache, const char * const *srcs)
+{
+    uint32_t format;
+    void *data;
+    int size;
+    int ret = ngli_program_cache_read(cache, srcs, 3, &format, &data, &size);
+    ngli_assert(ret >= 0);
+    if (!ret)
+        return 0;
+    ngli_assert(format == 0x1234);
+    ngli_assert(size == sizeof(binary));
+    ngli_assert(!memcmp(data, binary, size));
+    ngli_free(data);
+    return 1;
+}
+
+/* Apply func to every entry of the cache directory */
+static int for_each_entry(const char *dir, void (*func)(const char *path))
+{
+    int nb_entries = 0;
+    DIR *d = opendir(dir);
+    ngli_assert(d);
+    struct dirent *e;
+    while ((e = readdir(d))) {
+        const size_t len = strlen(e->d_name);
+        if (len < 4 || strcmp(e->d_name + len - 4, ".bin"))
+            continue;
+        char *path = ngli_asprintf("%s/%s", dir, e->d_name);
+        ngli_assert(path);
+        func(path);
+        ngli_free(path);
+        nb_entries++;
+    }
+    closedir(d);
+    return nb_entries;
+}
+
+static void truncate_entry(const char *path)
+{
+    FILE *fp = fopen(path, "rb");
+    ngli_assert(fp);
+    char header[8];
+    ngli_assert(fread(header, sizeof(header), 1, fp) == 1);
+    fclose(fp);
+    fp = fopen(path, "wb");
+    ngli_assert(fp);
+    ngli_assert(fwrite(header, sizeof(header), 1, fp) == 1);
+    fclose(fp);
+}
+
+/* Alter the identity stored before the binary, as another program with the same key would */
+static void alter_identity(const char *path)
+{
+    FILE *fp = fopen(path, "r+b");
+    ngli_assert(fp);
+    ngli_assert(!fseek(fp, -(long)sizeof(binary) - 1, SEEK_END));
+    ngli_assert(fputc('X', fp) != EOF);
+    fclose(fp);
+}
+
+static void remove_entry(const char *path)
+{
+    remove(path);
+}
+
+int main(int ac, char **av)
+{
+    const char *dir = ac > 1 ? av[1] : "test_program_cache.d";
+    mkdir(dir, 0755);
+    for_each_entry(dir, remove_entry);
+
+    struct program_cache *cache = ngli_program_cache_create(dir, "vendor\nrenderer\nversion");
+    ngli_assert(cache);
+
+    /* Roundtrip */
+    ngli_assert(!read_entry(cache, sources));
+    ngli_assert(!ngli_program_cache_write(cache, sources, 3, 0x1234, binary, sizeof(binary)));
+    ngli_assert(read_entry(cache, sources));
+    ngli_program_cache_validate(cache, 1);
+    check_stats(cache, 1, 1, 0);
+
+    /* Entries are keyed by all the sources, including the missing stages */
+    const char *compute_sources[] = {"vertex", "fragment", ""};
+    const char *swapped_sources[] = {"fragment", "vertex", NULL};
+    ngli_assert(!read_entry(cache, compute_sources));
+    ngli_assert(!read_entry(cache, swapped_sources));
+    check_stats(cache, 1, 3, 0);
+
+    /* Binary rejected by the driver */
+    ngli_assert(read_entry(cache, sources));
+    ngli_program_cache_validate(cache, 0);
+    check_stats(cache, 1, 3, 1);
+
+    /* Entries are only valid for the driver they have been written by */
+    struct program_cache *other_cache = ngli_program_cache_create(dir, "vendor\nrenderer\nversion2");
+    ngli_assert(other_cache);
+    ngli_assert(!read_entry(other_cache, sources));
+    check_stats(other_cache, 0, 1, 0);
+    ngli_program_cache_freep(&other_cache);
+    ngli_assert(!other_cache);
+
+    /* Corrupted entry */
+    ngli_assert(for_each_entry(dir, truncate_entry) == 1);
+    ngli_assert(!read_entry(cache, sources));
+    check_stats(cache, 1, 3, 2);
+
+    /* Overwritten entry */
+    ngli_assert(!ngli_program_cache_write(cache, sources, 3, 0x1234, binary, sizeof(binary)));
+    ngli_assert(read_entry(cache, sources));
+
+    /* Entry of another program whose key collides */
+    ngli_assert(for_each_entry(dir, alter_identity) == 1);
+    ngli_assert(!read_entry(cache, sources));
+    check_stats(cache, 1, 4, 2);
+
+    ngli_assert(for_each_entry(dir, remove_entry) == 1);
+    remove(dir);
+
+    ngli_program_cache_freep(&cache);
+    ngli_assert(!cache);
+    return 0;
+}
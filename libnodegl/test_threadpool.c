@@ -0,0 +1,72 @@
+/*
+ * Copyright 2018 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <string.h>
+
+#include "threadpool.h"
+#include "utils.h"
+
+#define NB_JOBS 1000
+
+static int fill_job(void *user_arg, int job_id)
+{
+    int *values = user_arg;
+    /* Uneven amount of work so the workers have to steal from each others */
+    volatile int dummy = 0;
+    for (int i = 0; i < (job_id % 7) * 1000; i++)
+        dummy += i;
+    values[job_id]++;
+    return 0;
+}
+
+static int fail_job(void *user_arg, int job_id)
+{
+    return job_id == 42 ? -1 : 0;
+}
+
+int main(void)
+{
+    static int values[NB_JOBS];
+
+    for (int nb_threads = 1; nb_threads <= 8; nb_threads++) {
+        struct threadpool *pool = ngli_threadpool_create(nb_threads);
+        ngli_assert(pool);
+
+        for (int run = 0; run < 10; run++) {
+            memset(values, 0, sizeof(values));
+            int ret = ngli_threadpool_run(pool, fill_job, values, NB_JOBS);
+            ngli_assert(ret == 0);
+            for (int i = 0; i < NB_JOBS; i++)
+                ngli_assert(values[i] == 1);
+        }
+
+        int ret = ngli_threadpool_run(pool, fail_job, NULL, NB_JOBS);
+        ngli_assert(ret == -1);
+
+        ret = ngli_threadpool_run(pool, fill_job, values, 0);
+        ngli_assert(ret == 0);
+
+        ngli_threadpool_freep(&pool);
+        ngli_assert(!pool);
+    }
+
+    return 0;
+}
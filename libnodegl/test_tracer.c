@@ -0,0 +1,91 @@
+/*
+ * Copyright 2018 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tracer.h"
+#include "utils.h"
+
+#define NB_THREADS 4
+#define NB_EVENTS 1000
+
+static void *record_events(void *arg)
+{
+    struct tracer *tracer = arg;
+    for (int i = 0; i < NB_EVENTS; i++) {
+        ngli_tracer_begin(tracer, "update", NULL);
+        ngli_tracer_begin(tracer, "draw", NULL);
+        ngli_tracer_end(tracer);
+        ngli_tracer_end(tracer);
+    }
+    return NULL;
+}
+
+static int count_occurrences(const char *str, const char *pattern)
+{
+    int count = 0;
+    while ((str = strstr(str, pattern))) {
+        count++;
+        str++;
+    }
+    return count;
+}
+
+int main(int ac, char **av)
+{
+    const char *filename = ac > 1 ? av[1] : "test_tracer.json";
+
+    struct tracer *tracer = ngli_tracer_create(filename);
+    ngli_assert(tracer);
+
+    pthread_t threads[NB_THREADS];
+    for (int i = 0; i < NB_THREADS; i++)
+        ngli_assert(!pthread_create(&threads[i], NULL, record_events, tracer));
+    for (int i = 0; i < NB_THREADS; i++)
+        pthread_join(threads[i], NULL);
+
+    int ret = ngli_tracer_freep(&tracer);
+    ngli_assert(ret == 0);
+    ngli_assert(!tracer);
+
+    FILE *fp = fopen(filename, "r");
+    ngli_assert(fp);
+    static char buf[1 << 23];
+    const size_t size = fread(buf, 1, sizeof(buf) - 1, fp);
+    fclose(fp);
+    remove(filename);
+    buf[size] = 0;
+
+    ngli_assert(!strncmp(buf, "{\"traceEvents\":[", 16));
+    ngli_assert(count_occurrences(buf, "\"ph\":\"B\"") == 2 * NB_THREADS * NB_EVENTS);
+    ngli_assert(count_occurrences(buf, "\"ph\":\"E\"") == 2 * NB_THREADS * NB_EVENTS);
+    ngli_assert(count_occurrences(buf, "\"cat\":\"draw\"") == NB_THREADS * NB_EVENTS);
+    for (int i = 0; i < NB_THREADS; i++) {
+        char tid[32];
+        snprintf(tid, sizeof(tid), "\"tid\":%d,", i);
+        ngli_assert(count_occurrences(buf, tid) == 4 * NB_EVENTS);
+    }
+
+    return 0;
+}
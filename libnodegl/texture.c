@@ -182,6 +182,29 @@ static int texture_init_fields(struct texture *s)
     return 0;
 }
 
+static void texture_account_memory(struct texture *s)
+{
+    const struct texture_params *params = &s->params;
+
+    int64_t size = (int64_t)params->width * params->height * NGLI_MAX(params->depth, 1)
+                 * ngli_format_get_bytes_per_pixel(params->format);
+
+    int category = NGL_MEMORY_TEXTURES;
+    if (s->target == GL_RENDERBUFFER) {
+        if (params->samples > 0) {
+            category = NGL_MEMORY_RENDERBUFFERS_MSAA;
+            size *= params->samples;
+        } else {
+            category = NGL_MEMORY_RENDERBUFFERS;
+        }
+    } else if (ngli_texture_has_mipmap(s)) {
+        /* The levels of a full mipmap chain add up to a third of the base */
+        size += size / 3;
+    }
+
+    ngli_memstats_add(&s->memstats, &s->gl->memstats, category, size);
+}
+
 int ngli_texture_init(struct texture *s,
                       struct glcontext *gl,
                       const struct texture_params *params)
@@ -197,6 +220,7 @@ int ngli_texture_init(struct texture *s,
         ngli_glGenRenderbuffers(gl, 1, &s->id);
         ngli_glBindRenderbuffer(gl, s->target, s->id);
         renderbuffer_set_storage(s);
+        texture_account_memory(s);
     } else {
         ngli_glGenTextures(gl, 1, &s->id);
         ngli_glBindTexture(gl, s->target, s->id);
@@ -220,6 +244,7 @@ int ngli_texture_init(struct texture *s,
             } else {
                 texture_set_image(s, NULL);
             }
+            texture_account_memory(s);
         }
     }
 
@@ -325,5 +350,6 @@ void ngli_texture_reset(struct texture *s)
             ngli_glDeleteTextures(gl, 1, &s->id);
     }
 
+    ngli_memstats_remove(&s->memstats);
     memset(s, 0, sizeof(*s));
 }
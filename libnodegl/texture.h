@@ -24,6 +24,7 @@
 
 #include "glincludes.h"
 #include "glcontext.h"
+#include "memstats.h"
 
 int ngli_texture_filter_has_mipmap(GLint filter);
 int ngli_texture_filter_has_linear_filtering(GLint filter);
@@ -72,6 +73,8 @@ struct texture {
     GLint format;
     GLint internal_format;
     GLenum format_type;
+
+    struct memstats_entry memstats;
 };
 
 int ngli_texture_init(struct texture *s,
@@ -0,0 +1,248 @@
+/*
+ * Copyright 2018 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <pthread.h>
+
+#include "memory.h"
+#include "threadpool.h"
+#include "utils.h"
+
+struct worker {
+    struct threadpool *pool;
+    int id;
+    pthread_t tid;
+    int has_thread;
+
+    /* Remaining jobs of the worker, in [begin, end) */
+    pthread_mutex_t lock;
+    int begin;
+    int end;
+};
+
+struct threadpool {
+    struct worker *workers;
+    int nb_workers;
+
+    pthread_mutex_t lock;
+    pthread_cond_t cond_wkr;
+    pthread_cond_t cond_ctl;
+    int run_id;
+    int nb_running;
+    int stop;
+
+    ngli_threadpool_job_func_type job_func;
+    void *user_arg;
+    int ret;
+};
+
+static int pop_job(struct worker *w)
+{
+    int job_id = -1;
+    pthread_mutex_lock(&w->lock);
+    if (w->begin < w->end)
+        job_id = w->begin++;
+    pthread_mutex_unlock(&w->lock);
+    return job_id;
+}
+
+static int steal_jobs(struct worker *w)
+{
+    struct threadpool *s = w->pool;
+
+    for (int i = 1; i < s->nb_workers; i++) {
+        struct worker *victim = &s->workers[(w->id + i) % s->nb_workers];
+
+        pthread_mutex_lock(&victim->lock);
+        const int nb_jobs = victim->end - victim->begin;
+        if (nb_jobs <= 0) {
+            pthread_mutex_unlock(&victim->lock);
+            continue;
+        }
+        const int nb_stolen = (nb_jobs + 1) / 2;
+        const int start = victim->end - nb_stolen;
+        victim->end = start;
+        pthread_mutex_unlock(&victim->lock);
+
+        pthread_mutex_lock(&w->lock);
+        w->begin = start + 1;
+        w->end = start + nb_stolen;
+        pthread_mutex_unlock(&w->lock);
+
+        return start;
+    }
+
+    return -1;
+}
+
+static void run_jobs(struct worker *w)
+{
+    struct threadpool *s = w->pool;
+
+    for (;;) {
+        int job_id = pop_job(w);
+        if (job_id < 0)
+            job_id = steal_jobs(w);
+        if (job_id < 0)
+            break;
+
+        int ret = s->job_func(s->user_arg, job_id);
+        if (ret < 0) {
+            pthread_mutex_lock(&s->lock);
+            if (!s->ret)
+                s->ret = ret;
+            pthread_mutex_unlock(&s->lock);
+        }
+    }
+}
+
+static void *worker_thread(void *arg)
+{
+    struct worker *w = arg;
+    struct threadpool *s = w->pool;
+    int run_id = 0;
+
+    ngli_thread_set_name("ngl-pool");
+
+    pthread_mutex_lock(&s->lock);
+    for (;;) {
+        while (!s->stop && s->run_id == run_id)
+            pthread_cond_wait(&s->cond_wkr, &s->lock);
+        if (s->stop)
+            break;
+        run_id = s->run_id;
+        pthread_mutex_unlock(&s->lock);
+
+        run_jobs(w);
+
+        pthread_mutex_lock(&s->lock);
+        if (--s->nb_running == 0)
+            pthread_cond_signal(&s->cond_ctl);
+    }
+    pthread_mutex_unlock(&s->lock);
+
+    return NULL;
+}
+
+struct threadpool *ngli_threadpool_create(int nb_threads)
+{
+    if (nb_threads < 1)
+        return NULL;
+
+    struct threadpool *s = ngli_calloc(1, sizeof(*s));
+    if (!s)
+        return NULL;
+
+    s->workers = ngli_calloc(nb_threads, sizeof(*s->workers));
+    if (!s->workers) {
+        ngli_free(s);
+        return NULL;
+    }
+
+    if (pthread_mutex_init(&s->lock, NULL) ||
+        pthread_cond_init(&s->cond_wkr, NULL) ||
+        pthread_cond_init(&s->cond_ctl, NULL)) {
+        pthread_cond_destroy(&s->cond_wkr);
+        pthread_mutex_destroy(&s->lock);
+        ngli_free(s->workers);
+        ngli_free(s);
+        return NULL;
+    }
+
+    for (int i = 0; i < nb_threads; i++) {
+        struct worker *w = &s->workers[i];
+        w->pool = s;
+        w->id = i;
+        pthread_mutex_init(&w->lock, NULL);
+        s->nb_workers++;
+
+        /* The first worker is the thread calling ngli_threadpool_run() */
+        if (i == 0)
+            continue;
+
+        if (pthread_create(&w->tid, NULL, worker_thread, w)) {
+            ngli_threadpool_freep(&s);
+            return NULL;
+        }
+        w->has_thread = 1;
+    }
+
+    return s;
+}
+
+int ngli_threadpool_run(struct threadpool *s, ngli_threadpool_job_func_type job_func,
+                        void *user_arg, int nb_jobs)
+{
+    if (nb_jobs <= 0)
+        return 0;
+
+    pthread_mutex_lock(&s->lock);
+    s->job_func = job_func;
+    s->user_arg = user_arg;
+    s->ret = 0;
+    for (int i = 0; i < s->nb_workers; i++) {
+        struct worker *w = &s->workers[i];
+        pthread_mutex_lock(&w->lock);
+        w->begin = (int)((int64_t)nb_jobs *  i      / s->nb_workers);
+        w->end   = (int)((int64_t)nb_jobs * (i + 1) / s->nb_workers);
+        pthread_mutex_unlock(&w->lock);
+    }
+    s->nb_running = s->nb_workers - 1;
+    s->run_id++;
+    pthread_cond_broadcast(&s->cond_wkr);
+    pthread_mutex_unlock(&s->lock);
+
+    run_jobs(&s->workers[0]);
+
+    pthread_mutex_lock(&s->lock);
+    while (s->nb_running)
+        pthread_cond_wait(&s->cond_ctl, &s->lock);
+    const int ret = s->ret;
+    pthread_mutex_unlock(&s->lock);
+
+    return ret;
+}
+
+void ngli_threadpool_freep(struct threadpool **sp)
+{
+    struct threadpool *s = *sp;
+
+    if (!s)
+        return;
+
+    pthread_mutex_lock(&s->lock);
+    s->stop = 1;
+    pthread_cond_broadcast(&s->cond_wkr);
+    pthread_mutex_unlock(&s->lock);
+
+    for (int i = 0; i < s->nb_workers; i++) {
+        struct worker *w = &s->workers[i];
+        if (w->has_thread)
+            pthread_join(w->tid, NULL);
+        pthread_mutex_destroy(&w->lock);
+    }
+
+    pthread_cond_destroy(&s->cond_ctl);
+    pthread_cond_destroy(&s->cond_wkr);
+    pthread_mutex_destroy(&s->lock);
+    ngli_free(s->workers);
+    ngli_free(*sp);
+    *sp = NULL;
+}
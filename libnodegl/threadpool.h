@@ -0,0 +1,49 @@
+/*
+ * Copyright 2018 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+typedef int (*ngli_threadpool_job_func_type)(void *user_arg, int job_id);
+
+struct threadpool;
+
+/*
+ * Create a pool of nb_threads workers. The thread calling
+ * ngli_threadpool_run() counts as one of them, so only nb_threads-1 threads
+ * are actually spawned.
+ */
+struct threadpool *ngli_threadpool_create(int nb_threads);
+
+/*
+ * Run job_func for every job id in [0, nb_jobs) and wait for all of them to
+ * complete. Each worker starts with a contiguous slice of the jobs and steals
+ * half of the remaining jobs of another worker once its own slice is
+ * exhausted.
+ *
+ * Returns the first error (< 0) raised by a job, 0 otherwise.
+ */
+int ngli_threadpool_run(struct threadpool *s, ngli_threadpool_job_func_type job_func,
+                        void *user_arg, int nb_jobs);
+
+void ngli_threadpool_freep(struct threadpool **sp);
+
+#endif /* THREADPOOL_H */
@@ -0,0 +1,195 @@
+/*
+ * Copyright 2018 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "darray.h"
+#include "log.h"
+#include "memory.h"
+#include "nodes.h"
+#include "tracer.h"
+#include "utils.h"
+
+#define MAX_THREADS 64
+
+struct event {
+    int64_t ts;
+    const char *op;         /* NULL for an end event */
+    const char *class_name; /* NULL if the operation is not tied to a node */
+    char label[48];
+};
+
+struct thread_events {
+    pthread_t thread;
+    struct darray events;
+};
+
+struct tracer {
+    char *filename;
+    int64_t start_time;
+    pthread_mutex_t lock;   /* only taken to register a new thread */
+    struct thread_events threads[MAX_THREADS];
+    int nb_threads;
+};
+
+struct tracer *ngli_tracer_create(const char *filename)
+{
+    struct tracer *s = ngli_calloc(1, sizeof(*s));
+    if (!s)
+        return NULL;
+
+    s->filename = ngli_strdup(filename);
+    if (!s->filename || pthread_mutex_init(&s->lock, NULL)) {
+        ngli_free(s->filename);
+        ngli_free(s);
+        return NULL;
+    }
+    s->start_time = ngli_gettime();
+
+    return s;
+}
+
+static struct darray *get_thread_events(struct tracer *s)
+{
+    const pthread_t self = pthread_self();
+
+    /*
+     * Threads are only ever appended, and a thread only registers itself, so
+     * the entries published so far can be looked up without the lock.
+     */
+    const int nb_threads = __atomic_load_n(&s->nb_threads, __ATOMIC_ACQUIRE);
+    for (int i = 0; i < nb_threads; i++)
+        if (pthread_equal(s->threads[i].thread, self))
+            return &s->threads[i].events;
+
+    pthread_mutex_lock(&s->lock);
+    struct darray *events = NULL;
+    if (s->nb_threads < MAX_THREADS) {
+        struct thread_events *thread = &s->threads[s->nb_threads];
+        thread->thread = self;
+        ngli_darray_init(&thread->events, sizeof(struct event), 0);
+        events = &thread->events;
+        __atomic_store_n(&s->nb_threads, s->nb_threads + 1, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&s->lock);
+    return events;
+}
+
+void ngli_tracer_begin(struct tracer *s, const char *op, const struct ngl_node *node)
+{
+    struct darray *events = get_thread_events(s);
+    if (!events)
+        return;
+
+    struct event *event = ngli_darray_push(events, NULL);
+    if (!event)
+        return;
+    event->ts = ngli_gettime();
+    event->op = op;
+    event->class_name = node ? node->class->name : NULL;
+    snprintf(event->label, sizeof(event->label), "%s", node ? node->label : op);
+}
+
+void ngli_tracer_end(struct tracer *s)
+{
+    struct darray *events = get_thread_events(s);
+    if (!events)
+        return;
+
+    struct event *event = ngli_darray_push(events, NULL);
+    if (!event)
+        return;
+    event->ts = ngli_gettime();
+    event->op = NULL;
+}
+
+static void write_string(FILE *fp, const char *str)
+{
+    fputc('"', fp);
+    for (; *str; str++) {
+        if (*str == '"' || *str == '\\')
+            fprintf(fp, "\\%c", *str);
+        else if ((unsigned char)*str < 0x20)
+            fprintf(fp, "\\u%04x", *str);
+        else
+            fputc(*str, fp);
+    }
+    fputc('"', fp);
+}
+
+static int write_trace(const struct tracer *s)
+{
+    FILE *fp = fopen(s->filename, "w");
+    if (!fp) {
+        LOG(ERROR, "could not open trace file %s", s->filename);
+        return -1;
+    }
+
+    const char *sep = "";
+    fprintf(fp, "{\"traceEvents\":[");
+    for (int tid = 0; tid < s->nb_threads; tid++) {
+        const struct darray *events_array = &s->threads[tid].events;
+        const struct event *events = ngli_darray_data(events_array);
+        for (int i = 0; i < ngli_darray_count(events_array); i++) {
+            const struct event *event = &events[i];
+            fprintf(fp, "%s\n{\"ph\":\"%c\",\"pid\":0,\"tid\":%d,\"ts\":%" PRId64,
+                    sep, event->op ? 'B' : 'E', tid, event->ts - s->start_time);
+            if (event->op) {
+                fprintf(fp, ",\"name\":");
+                write_string(fp, event->label);
+                fprintf(fp, ",\"cat\":\"%s\"", event->op);
+                if (event->class_name)
+                    fprintf(fp, ",\"args\":{\"class\":\"%s\"}", event->class_name);
+            }
+            fputc('}', fp);
+            sep = ",";
+        }
+    }
+    fprintf(fp, "\n]}\n");
+
+    const int ret = ferror(fp) ? -1 : 0;
+    if (fclose(fp) || ret < 0) {
+        LOG(ERROR, "could not write trace file %s", s->filename);
+        return -1;
+    }
+    return 0;
+}
+
+int ngli_tracer_freep(struct tracer **sp)
+{
+    struct tracer *s = *sp;
+
+    if (!s)
+        return 0;
+
+    const int ret = write_trace(s);
+
+    for (int i = 0; i < s->nb_threads; i++)
+        ngli_darray_reset(&s->threads[i].events);
+    pthread_mutex_destroy(&s->lock);
+    ngli_free(s->filename);
+    ngli_free(*sp);
+    *sp = NULL;
+    return ret;
+}
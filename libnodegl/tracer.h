@@ -0,0 +1,59 @@
+/*
+ * Copyright 2018 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef TRACER_H
+#define TRACER_H
+
+struct ngl_node;
+struct tracer;
+
+/*
+ * Record timestamped begin/end events of the lifecycle of the nodes from any
+ * thread, and write them in the Chrome trace event format (which can be
+ * loaded in chrome://tracing) when destroyed. Each thread records its events
+ * in its own buffer, so recording does not involve any lock.
+ */
+struct tracer *ngli_tracer_create(const char *filename);
+
+/*
+ * Begin an operation, such as "update", on a node. The node can be NULL for
+ * operations not tied to a node. Events of a thread must be properly nested.
+ */
+void ngli_tracer_begin(struct tracer *s, const char *op, const struct ngl_node *node);
+void ngli_tracer_end(struct tracer *s);
+
+/*
+ * Write the recorded events in the trace file and destroy the tracer. No
+ * event must be recorded concurrently.
+ */
+int ngli_tracer_freep(struct tracer **sp);
+
+#define NGLI_TRACER_BEGIN(s, op, node) do { \
+    if (s)                                  \
+        ngli_tracer_begin(s, op, node);     \
+} while (0)
+
+#define NGLI_TRACER_END(s) do { \
+    if (s)                      \
+        ngli_tracer_end(s);     \
+} while (0)
+
+#endif /* TRACER_H */
@@ -0,0 +1,589 @@
+/*
+ * Copyright 2018 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <nodegl.h>
+
+#include "common.h"
+
+static const char fragment[] =
+    "#version 100"                                                      "\n"
+    "precision highp float;"                                            "\n"
+    "uniform vec4 color;"                                               "\n"
+    "void main(void)"                                                   "\n"
+    "{"                                                                 "\n"
+    "    gl_FragColor = color;"                                         "\n"
+    "}";
+
+static const char tex_fragment[] =
+    "#version 100"                                                      "\n"
+    "precision highp float;"                                            "\n"
+    "uniform sampler2D tex0_sampler;"                                   "\n"
+    "varying vec2 var_tex0_coord;"                                      "\n"
+    "void main(void)"                                                   "\n"
+    "{"                                                                 "\n"
+    "    gl_FragColor = texture2D(tex0_sampler, var_tex0_coord);"       "\n"
+    "}";
+
+struct bench_ctx {
+    struct ngl_node *quad;
+    struct ngl_node *program;
+    struct ngl_node *tex_program;
+    int nb_created;
+};
+
+static struct ngl_node *get_render(struct bench_ctx *b)
+{
+    struct ngl_node *render = ngl_node_create(NGL_NODE_RENDER, b->quad);
+    struct ngl_node *color  = ngl_node_create(NGL_NODE_UNIFORMVEC4);
+    const float value[4] = {(b->nb_created & 0xff) / 255.f, 0.5f, 0.5f, 1.f};
+
+    ngl_node_param_set(color, "value", value);
+    ngl_node_param_set(render, "program", b->program);
+    ngl_node_param_set(render, "uniforms", "color", color);
+    ngl_node_unrefp(&color);
+    b->nb_created += 2;
+    return render;
+}
+
+/* One node out of 8 is animated so the graph is not entirely static */
+static struct ngl_node *get_transform(struct bench_ctx *b, struct ngl_node *child)
+{
+    if (b->nb_created % 8) {
+        static const float vector[3] = {0.001f, 0.0f, 0.0f};
+        struct ngl_node *translate = ngl_node_create(NGL_NODE_TRANSLATE, child);
+        ngl_node_param_set(translate, "vector", vector);
+        b->nb_created++;
+        return translate;
+    }
+
+    struct ngl_node *kfs[] = {
+        ngl_node_create(NGL_NODE_ANIMKEYFRAMEFLOAT, 0.0, 0.0),
+        ngl_node_create(NGL_NODE_ANIMKEYFRAMEFLOAT, 10.0, 360.0),
+    };
+    struct ngl_node *anim   = ngl_node_create(NGL_NODE_ANIMATEDFLOAT);
+    struct ngl_node *rotate = ngl_node_create(NGL_NODE_ROTATE, child);
+    ngl_node_param_add(anim, "keyframes", 2, kfs);
+    ngl_node_param_set(rotate, "anim", anim);
+    ngl_node_unrefp(&kfs[0]);
+    ngl_node_unrefp(&kfs[1]);
+    ngl_node_unrefp(&anim);
+    b->nb_created += 4;
+    return rotate;
+}
+
+/* Every level is a Group holding a Render and the next (transformed) level */
+static struct ngl_node *get_deep_scene(struct bench_ctx *b, int nb_levels)
+{
+    struct ngl_node *scene = NULL;
+    for (int i = 0; i < nb_levels; i++) {
+        struct ngl_node *group = ngl_node_create(NGL_NODE_GROUP);
+        struct ngl_node *render = get_render(b);
+        ngl_node_param_add(group, "children", 1, &render);
+        ngl_node_unrefp(&render);
+        if (scene) {
+            ngl_node_param_add(group, "children", 1, &scene);
+            ngl_node_unrefp(&scene);
+        }
+        b->nb_created++;
+        scene = get_transform(b, group);
+        ngl_node_unrefp(&group);
+    }
+    return scene;
+}
+
+/* A single Group holding all the (transformed) Render */
+static struct ngl_node *get_wide_scene(struct bench_ctx *b, int nb_children)
+{
+    struct ngl_node *scene = ngl_node_create(NGL_NODE_GROUP);
+    for (int i = 0; i < nb_children; i++) {
+        struct ngl_node *render = get_render(b);
+        struct ngl_node *child = get_transform(b, render);
+        ngl_node_param_add(scene, "children", 1, &child);
+        ngl_node_unrefp(&child);
+        ngl_node_unrefp(&render);
+    }
+    b->nb_created++;
+    return scene;
+}
+
+/* A Group of Render, each drawing a geometry with animated vertices */
+#define NB_ANIM_VERTICES 1024
+static struct ngl_node *get_anim_scene(struct bench_ctx *b, int nb_children)
+{
+    static float data[2][NB_ANIM_VERTICES * 3];
+    for (int i = 0; i < NB_ANIM_VERTICES * 3; i++) {
+        data[0][i] = (i % 7) / 7.f - 0.5f;
+        data[1][i] = (i % 5) / 5.f - 0.5f;
+    }
+
+    struct ngl_node *scene = ngl_node_create(NGL_NODE_GROUP);
+    for (int i = 0; i < nb_children; i++) {
+        struct ngl_node *kfs[] = {
+            ngl_node_create(NGL_NODE_ANIMKEYFRAMEBUFFER, 0.0),
+            ngl_node_create(NGL_NODE_ANIMKEYFRAMEBUFFER, 10.0),
+        };
+        ngl_node_param_set(kfs[0], "data", (int)sizeof(data[0]), data[0]);
+        ngl_node_param_set(kfs[1], "data", (int)sizeof(data[1]), data[1]);
+
+        struct ngl_node *vertices = ngl_node_create(NGL_NODE_ANIMATEDBUFFERVEC3);
+        ngl_node_param_add(vertices, "keyframes", 2, kfs);
+        ngl_node_unrefp(&kfs[0]);
+        ngl_node_unrefp(&kfs[1]);
+
+        struct ngl_node *geometry = ngl_node_create(NGL_NODE_GEOMETRY, vertices);
+        struct ngl_node *render = ngl_node_create(NGL_NODE_RENDER, geometry);
+        ngl_node_param_set(render, "program", b->program);
+        ngl_node_param_add(scene, "children", 1, &render);
+        ngl_node_unrefp(&vertices);
+        ngl_node_unrefp(&geometry);
+        ngl_node_unrefp(&render);
+        b->nb_created += 6;
+    }
+    b->nb_created++;
+    return scene;
+}
+
+/*
+ * A Group of sequential time ranges (one per frame), each holding a Render with
+ * its own Program
+ */
+static struct ngl_node *get_timeline_scene(struct bench_ctx *b, int nb_children)
+{
+    struct ngl_node *scene = ngl_node_create(NGL_NODE_GROUP);
+    for (int i = 0; i < nb_children; i++) {
+        char fragment_i[sizeof(fragment) + 32];
+        snprintf(fragment_i, sizeof(fragment_i), "%s\n// clip %d", fragment, i);
+        struct ngl_node *program = ngl_node_create(NGL_NODE_PROGRAM);
+        ngl_node_param_set(program, "fragment", fragment_i);
+
+        struct ngl_node *render = get_render(b);
+        ngl_node_param_set(render, "program", program);
+
+        struct ngl_node *ranges[] = {
+            ngl_node_create(NGL_NODE_TIMERANGEMODENOOP, 0.0),
+            ngl_node_create(NGL_NODE_TIMERANGEMODECONT, i / 60.),
+            ngl_node_create(NGL_NODE_TIMERANGEMODENOOP, (i + 1) / 60.),
+        };
+        struct ngl_node *trf = ngl_node_create(NGL_NODE_TIMERANGEFILTER, render);
+        ngl_node_param_add(trf, "ranges", 3, ranges);
+        ngl_node_param_add(scene, "children", 1, &trf);
+        for (int j = 0; j < 3; j++)
+            ngl_node_unrefp(&ranges[j]);
+        ngl_node_unrefp(&trf);
+        ngl_node_unrefp(&render);
+        ngl_node_unrefp(&program);
+        b->nb_created += 6;
+    }
+    b->nb_created++;
+    return scene;
+}
+
+/*
+ * A Group of sequential time ranges (one every 10 frames), each holding a
+ * Render of its own texture, which needs to be uploaded when the range is
+ * prefetched
+ */
+#define TEXTURE_SIZE 512
+static struct ngl_node *get_texture_scene(struct bench_ctx *b, int nb_children)
+{
+    static uint8_t data[TEXTURE_SIZE * TEXTURE_SIZE * 4];
+
+    struct ngl_node *scene = ngl_node_create(NGL_NODE_GROUP);
+    for (int i = 0; i < nb_children; i++) {
+        memset(data, i & 0xff, sizeof(data));
+        struct ngl_node *buffer = ngl_node_create(NGL_NODE_BUFFERUBVEC4);
+        ngl_node_param_set(buffer, "data", (int)sizeof(data), data);
+
+        struct ngl_node *texture = ngl_node_create(NGL_NODE_TEXTURE2D);
+        ngl_node_param_set(texture, "data_src", buffer);
+        ngl_node_param_set(texture, "width", TEXTURE_SIZE);
+        ngl_node_param_set(texture, "height", TEXTURE_SIZE);
+
+        struct ngl_node *render = ngl_node_create(NGL_NODE_RENDER, b->quad);
+        ngl_node_param_set(render, "program", b->tex_program);
+        ngl_node_param_set(render, "textures", "tex0", texture);
+
+        struct ngl_node *ranges[] = {
+            ngl_node_create(NGL_NODE_TIMERANGEMODENOOP, 0.0),
+            ngl_node_create(NGL_NODE_TIMERANGEMODECONT, i / 6.),
+            ngl_node_create(NGL_NODE_TIMERANGEMODENOOP, (i + 1) / 6.),
+        };
+        struct ngl_node *trf = ngl_node_create(NGL_NODE_TIMERANGEFILTER, render);
+        ngl_node_param_add(trf, "ranges", 3, ranges);
+        ngl_node_param_add(scene, "children", 1, &trf);
+        for (int j = 0; j < 3; j++)
+            ngl_node_unrefp(&ranges[j]);
+        ngl_node_unrefp(&trf);
+        ngl_node_unrefp(&render);
+        ngl_node_unrefp(&texture);
+        ngl_node_unrefp(&buffer);
+        b->nb_created += 7;
+    }
+    b->nb_created++;
+    return scene;
+}
+
+struct bench_opts {
+    int nb_threads;
+    int lazy_init;
+    int prefetch_thread;
+    double prefetch_budget;
+    int deserialize;
+    int size;
+    int nb_frames;
+    int width;
+    int height;
+};
+
+static int cmp_time(const void *a, const void *b)
+{
+    const int64_t ta = *(const int64_t *)a;
+    const int64_t tb = *(const int64_t *)b;
+    return (ta > tb) - (ta < tb);
+}
+
+static struct ngl_node *get_scene(struct bench_ctx *b, const char *name, int size)
+{
+    static const float corner[3] = {-0.5f, -0.5f, 0.0f};
+    static const float width_v[3] = {1.0f, 0.0f, 0.0f};
+    static const float height_v[3] = {0.0f, 1.0f, 0.0f};
+    b->quad = ngl_node_create(NGL_NODE_QUAD);
+    b->program = ngl_node_create(NGL_NODE_PROGRAM);
+    b->tex_program = ngl_node_create(NGL_NODE_PROGRAM);
+    if (!b->quad || !b->program || !b->tex_program)
+        return NULL;
+    ngl_node_param_set(b->quad, "corner", corner);
+    ngl_node_param_set(b->quad, "width", width_v);
+    ngl_node_param_set(b->quad, "height", height_v);
+    ngl_node_param_set(b->program, "fragment", fragment);
+    ngl_node_param_set(b->tex_program, "fragment", tex_fragment);
+
+    if (!strcmp(name, "deep"))
+        return get_deep_scene(b, size);
+    else if (!strcmp(name, "wide"))
+        return get_wide_scene(b, size);
+    else if (!strcmp(name, "anim"))
+        return get_anim_scene(b, size);
+    else if (!strcmp(name, "timeline"))
+        return get_timeline_scene(b, size);
+    return get_texture_scene(b, size);
+}
+
+static void reset_bench_ctx(struct bench_ctx *b)
+{
+    ngl_node_unrefp(&b->quad);
+    ngl_node_unrefp(&b->program);
+    ngl_node_unrefp(&b->tex_program);
+}
+
+static int run_bench(const char *name, int compiled, const struct bench_opts *o)
+{
+    int ret = -1;
+    struct bench_ctx b = {0};
+    struct ngl_ctx *ctx = NULL;
+    struct ngl_node *scene = NULL;
+    int64_t *frame_times = calloc(o->nb_frames, sizeof(*frame_times));
+    if (!frame_times)
+        return -1;
+
+    scene = get_scene(&b, name, o->size);
+    if (!scene)
+        goto end;
+
+    ctx = ngl_create();
+    if (!ctx)
+        goto end;
+
+    struct ngl_config config = {
+        .width             = o->width,
+        .height            = o->height,
+        .viewport          = {0, 0, o->width, o->height},
+        .offscreen         = 1,
+        .compiled_scene    = compiled,
+        .nb_update_threads = o->nb_threads,
+        .lazy_init         = o->lazy_init,
+        .prefetch_thread   = o->prefetch_thread,
+        .prefetch_budget   = o->prefetch_budget,
+    };
+    ret = ngl_configure(ctx, &config);
+    if (ret < 0)
+        goto end;
+
+    const int64_t set_scene_start = gettime();
+    ret = ngl_set_scene(ctx, scene);
+    if (ret < 0)
+        goto end;
+    const int64_t set_scene_time = gettime() - set_scene_start;
+
+    const int64_t start = gettime();
+    for (int i = 0; i < o->nb_frames; i++) {
+        const int64_t frame_start = gettime();
+        ret = ngl_draw(ctx, i / 60.);
+        if (ret < 0)
+            goto end;
+        frame_times[i] = gettime() - frame_start;
+    }
+    const int64_t draw_time = gettime() - start;
+
+    qsort(frame_times, o->nb_frames, sizeof(*frame_times), cmp_time);
+    const int64_t p99_frame_time = frame_times[o->nb_frames * 99 / 100];
+    const int64_t max_frame_time = frame_times[o->nb_frames - 1];
+
+    printf("%-8s %-9s %6d nodes: set_scene %8.3fms, %7.1fus/frame, p99 %8.1fus, max %8.1fus\n",
+           name, compiled ? "compiled" : "recursive", b.nb_created,
+           set_scene_time / 1000., draw_time / (double)o->nb_frames,
+           (double)p99_frame_time, (double)max_frame_time);
+
+end:
+    ngl_freep(&ctx);
+    ngl_node_unrefp(&scene);
+    reset_bench_ctx(&b);
+    free(frame_times);
+    return ret;
+}
+
+/* Resident memory of the process in bytes, or -1 if unknown */
+static int64_t get_rss(void)
+{
+    FILE *fp = fopen("/proc/self/statm", "r");
+    if (!fp)
+        return -1;
+    long size, resident;
+    const int n = fscanf(fp, "%ld %ld", &size, &resident);
+    fclose(fp);
+    return n == 2 ? resident * (int64_t)sysconf(_SC_PAGESIZE) : -1;
+}
+
+#define NB_DESERIALIZE_ROUNDS 10
+
+/*
+ * Compare the de-serialization of a scene with the nodes individually
+ * allocated and with the nodes packed in an arena: de-serialization time,
+ * release time of the resulting graph (a full walk of it) and resident memory
+ * growth.
+ */
+static int run_deserialize_bench(const char *name, const struct bench_opts *o)
+{
+    int ret = -1;
+    struct bench_ctx b = {0};
+    char *serialized = NULL;
+    struct ngl_node *scene = get_scene(&b, name, o->size);
+    if (!scene)
+        goto end;
+    serialized = ngl_node_serialize(scene);
+    if (!serialized)
+        goto end;
+
+    for (int use_arena = 0; use_arena <= 1; use_arena++) {
+        int64_t deserialize_time = 0;
+        int64_t release_time = 0;
+        int64_t rss_growth = -1;
+
+        for (int i = 0; i < NB_DESERIALIZE_ROUNDS; i++) {
+            struct ngl_arena *arena = NULL;
+            if (use_arena) {
+                arena = ngl_arena_create();
+                if (!arena)
+                    goto end;
+            }
+
+            const int64_t rss_start = get_rss();
+            const int64_t start = gettime();
+            struct ngl_node *copy = use_arena ? ngl_node_deserialize_arena(arena, serialized)
+                                              : ngl_node_deserialize(serialized);
+            deserialize_time += gettime() - start;
+            ngl_arena_unrefp(&arena);
+            if (!copy)
+                goto end;
+            if (i == 0 && rss_start >= 0)
+                rss_growth = get_rss() - rss_start;
+
+            const int64_t release_start = gettime();
+            ngl_node_unrefp(&copy);
+            release_time += gettime() - release_start;
+        }
+
+        printf("%-8s %-9s %6d nodes: deserialize %8.3fms, release %8.3fms, rss +%7.1fKiB\n",
+               name, use_arena ? "arena" : "heap", b.nb_created,
+               deserialize_time / 1000. / NB_DESERIALIZE_ROUNDS,
+               release_time / 1000. / NB_DESERIALIZE_ROUNDS,
+               rss_growth / 1024.);
+    }
+
+    ret = 0;
+
+end:
+    free(serialized);
+    ngl_node_unrefp(&scene);
+    reset_bench_ctx(&b);
+    return ret;
+}
+
+/* Per-draw overhead of the command dispatch, with an empty scene */
+static int run_dispatch_bench(int nb_frames, int width, int height)
+{
+    int ret = -1;
+    struct ngl_ctx *ctx = NULL;
+    struct ngl_node *scene = ngl_node_create(NGL_NODE_GROUP);
+    if (!scene)
+        goto end;
+
+    ctx = ngl_create();
+    if (!ctx)
+        goto end;
+
+    struct ngl_config config = {
+        .width     = width,
+        .height    = height,
+        .viewport  = {0, 0, width, height},
+        .offscreen = 1,
+    };
+    ret = ngl_configure(ctx, &config);
+    if (ret < 0)
+        goto end;
+
+    ret = ngl_set_scene(ctx, scene);
+    if (ret < 0)
+        goto end;
+
+    int64_t start = gettime();
+    for (int i = 0; i < nb_frames; i++) {
+        ret = ngl_draw(ctx, i / 60.);
+        if (ret < 0)
+            goto end;
+    }
+    const int64_t sync_time = gettime() - start;
+
+    start = gettime();
+    for (int i = 0; i < nb_frames; i++) {
+        ret = ngl_draw_async(ctx, i / 60.);
+        if (ret < 0)
+            goto end;
+    }
+    ret = ngl_wait(ctx);
+    if (ret < 0)
+        goto end;
+    const int64_t async_time = gettime() - start;
+
+    printf("dispatch (empty scene): %6.1fus/draw, %6.1fus/draw_async\n",
+           sync_time / (double)nb_frames, async_time / (double)nb_frames);
+
+end:
+    ngl_freep(&ctx);
+    ngl_node_unrefp(&scene);
+    return ret;
+}
+
+int main(int argc, char *argv[])
+{
+    struct bench_opts o = {
+        .size      = 500,
+        .nb_frames = 300,
+        .width     = 64,
+        .height    = 64,
+    };
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-l")) {
+            o.lazy_init = 1;
+        } else if (!strcmp(argv[i], "-p")) {
+            o.prefetch_thread = 1;
+        } else if (!strcmp(argv[i], "-d")) {
+            o.deserialize = 1;
+        } else if (argv[i][0] == '-' && i < argc - 1) {
+            const char opt = argv[i][1];
+            const char *arg = argv[i + 1];
+            switch (opt) {
+                case 'n':
+                    o.size = atoi(arg);
+                    break;
+                case 'f':
+                    o.nb_frames = atoi(arg);
+                    break;
+                case 'j':
+                    o.nb_threads = atoi(arg);
+                    break;
+                case 'b':
+                    o.prefetch_budget = atof(arg) / 1000.;
+                    break;
+                case 's':
+                    if (sscanf(arg, "%dx%d", &o.width, &o.height) != 2) {
+                        fprintf(stderr, "Invalid size format: \"%s\" "
+                                "is not following \"WxH\"\n", arg);
+                        return EXIT_FAILURE;
+                    }
+                    break;
+                default:
+                    fprintf(stderr, "Unknown option -%c\n", opt);
+                    return EXIT_FAILURE;
+            }
+            i++;
+        } else {
+            fprintf(stderr, "Usage: %s [-n size] [-f nb_frames] [-j nb_threads] [-l] [-p] [-d] [-b budget_ms] [-s WxH]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (o.size <= 0 || o.nb_frames <= 0) {
+        fprintf(stderr, "Size and number of frames must be positive\n");
+        return EXIT_FAILURE;
+    }
+
+    ngl_log_set_min_level(NGL_LOG_WARNING);
+
+    static const char *scenes[] = {"deep", "wide", "anim", "timeline", "texture"};
+
+    if (o.deserialize) {
+        /* The texture scene is skipped: its cost is dominated by the texture data */
+        for (int i = 0; i < sizeof(scenes) / sizeof(*scenes) - 1; i++) {
+            if (run_deserialize_bench(scenes[i], &o) < 0) {
+                fprintf(stderr, "Unable to run %s deserialization benchmark\n", scenes[i]);
+                return EXIT_FAILURE;
+            }
+        }
+        return 0;
+    }
+
+    if (run_dispatch_bench(o.nb_frames, o.width, o.height) < 0) {
+        fprintf(stderr, "Unable to run dispatch benchmark\n");
+        return EXIT_FAILURE;
+    }
+
+    printf("%d update threads, %s init, %s prefetch, %gms prefetch budget\n", o.nb_threads,
+           o.lazy_init ? "lazy" : "eager", o.prefetch_thread ? "threaded" : "synchronous",
+           o.prefetch_budget * 1000.);
+
+    for (int i = 0; i < sizeof(scenes) / sizeof(*scenes); i++) {
+        for (int compiled = 0; compiled <= 1; compiled++) {
+            if (run_bench(scenes[i], compiled, &o) < 0) {
+                fprintf(stderr, "Unable to run %s benchmark\n", scenes[i]);
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    return 0;
+}
@@ -69,6 +69,26 @@ struct range {
     int freq;
 };
 
+struct range_ctx {
+    int debug;
+    int range_id;
+    int nb_ranges;
+    const struct range *range;
+    int nb_frames;
+};
+
+/* Called from the rendering thread after every frame of a range */
+static int frame_done(void *user_arg, int frame_index, double t)
+{
+    struct range_ctx *c = user_arg;
+    const struct range *r = c->range;
+    if (c->debug)
+        printf("drawn @ t=%f [range %d/%d: %g-%g @ %dHz]\n",
+               t, c->range_id + 1, c->nb_ranges, r->start, r->start + r->duration, r->freq);
+    c->nb_frames = frame_index + 1;
+    return 0;
+}
+
 int main(int argc, char *argv[])
 {
     int ret = 0;
@@ -81,6 +101,7 @@ int main(int argc, char *argv[])
     int show_window = 0;
     int swap_interval = 0;
     int debug = 0;
+    const char *trace = NULL;
     GLFWwindow *window = NULL;
 
     for (int i = 1; i < argc; i++) {
@@ -105,6 +126,9 @@ int main(int argc, char *argv[])
                 case 'z':
                     swap_interval = atoi(arg);
                     break;
+                case 'p':
+                    trace = arg;
+                    break;
                 case 't':
                     if (nb_ranges >= sizeof(ranges)/sizeof(*ranges)) {
                         fprintf(stderr, "Too much ranges specified (max:%d)\n",
@@ -132,7 +156,7 @@ int main(int argc, char *argv[])
     }
 
     if (!input) {
-        fprintf(stderr, "Usage: %s [-o out.raw] [-s WxH] [-w] [-d] [-z swapinterval] input.ngl\n", argv[0]);
+        fprintf(stderr, "Usage: %s [-o out.raw] [-s WxH] [-w] [-d] [-z swapinterval] [-p trace.json] input.ngl\n", argv[0]);
         return EXIT_FAILURE;
     }
 
@@ -209,40 +233,47 @@ int main(int argc, char *argv[])
         goto end;
     }
 
+    if (trace) {
+        ret = ngl_trace_start(ctx, trace);
+        if (ret < 0) {
+            ngl_node_unrefp(&scene);
+            goto end;
+        }
+    }
+
     ret = ngl_set_scene(ctx, scene);
     ngl_node_unrefp(&scene);
     if (ret < 0)
         goto end;
 
     for (int i = 0; i < nb_ranges; i++) {
-        int k = 0;
         const struct range *r = &ranges[i];
-        const float t0 = r->start;
-        const float t1 = r->start + r->duration;
+        struct range_ctx range_ctx = {
+            .debug     = debug,
+            .range_id  = i,
+            .nb_ranges = nb_ranges,
+            .range     = r,
+        };
 
         const int64_t start = gettime();
 
-        for (;;) {
-            const float t = t0 + k*1./r->freq;
-            if (t >= t1)
-                break;
-            if (debug)
-                printf("draw @ t=%f [range %d/%d: %g-%g @ %dHz]\n",
-                       t, i + 1, nb_ranges, t0, t1, r->freq);
-            ret = ngl_draw(ctx, t);
-            if (ret < 0) {
-                fprintf(stderr, "Unable to draw @ t=%g\n", t);
-                goto end;
-            }
-            if (show_window)
-                glfwPollEvents();
-            k++;
+        ret = ngl_draw_range(ctx, r->start, r->start + r->duration, r->freq,
+                             frame_done, &range_ctx);
+        if (ret < 0) {
+            fprintf(stderr, "Unable to draw range %d/%d\n", i + 1, nb_ranges);
+            goto end;
         }
+        if (show_window)
+            glfwPollEvents();
 
+        const int k = range_ctx.nb_frames;
         const double tdiff = (gettime() - start) / 1000000.;
         printf("Rendered %d frames in %g (FPS=%g)\n", k, tdiff, k / tdiff);
     }
 
+    if (trace)
+        ret = ngl_trace_stop(ctx);
+
 end:
     ngl_freep(&ctx);
 
@@ -1,6 +1,6 @@
 from libc.stdlib cimport calloc
 from libc.string cimport memset
-from libc.stdint cimport uintptr_t
+from libc.stdint cimport int64_t, uintptr_t
 
 cdef extern from "nodegl.h":
     cdef int NGL_LOG_VERBOSE
@@ -13,6 +13,18 @@ cdef extern from "nodegl.h":
 
     cdef struct ngl_node
 
+    cdef int NGL_MEMORY_BUFFERS
+    cdef int NGL_MEMORY_TEXTURES
+    cdef int NGL_MEMORY_RENDERBUFFERS
+    cdef int NGL_MEMORY_RENDERBUFFERS_MSAA
+    cdef int NGL_MEMORY_FRAMEBUFFERS
+    cdef int NGL_MEMORY_BUFFERS_CPU
+    cdef int NGL_NB_MEMORY
+
+    cdef struct ngl_memory_stats:
+        int64_t sizes[6]
+        int counts[6]
+
     ngl_node *ngl_node_create(int type, ...)
     ngl_node *ngl_node_ref(ngl_node *node)
     void ngl_node_unrefp(ngl_node **nodep)
@@ -22,6 +34,7 @@ cdef extern from "nodegl.h":
     int ngl_node_param_set(ngl_node *node, const char *key, ...)
     char *ngl_node_dot(const ngl_node *node)
     char *ngl_node_serialize(const ngl_node *node)
+    int ngl_node_get_memory_stats(const ngl_node *node, ngl_memory_stats *stats)
     ngl_node *ngl_node_deserialize(const char *s)
 
     int ngl_anim_evaluate(ngl_node *anim, void *dst, double t)
@@ -53,11 +66,50 @@ cdef extern from "nodegl.h":
         int  samples
         int  set_surface_pts
         float clear_color[4]
+        int  compiled_scene
+        int  nb_update_threads
+        int  lazy_init
+        int  prefetch_thread
+        double prefetch_budget
+        int hot_swap
+        const char *program_cache_dir
+
+    cdef struct ngl_program_cache_stats:
+        int hits
+        int misses
+        int stale
+
+    cdef struct ngl_uniform_stats:
+        int64_t issued
+        int64_t skipped
+
+    cdef struct ngl_binding_stats:
+        int64_t issued
+        int64_t elided
+
+    cdef struct ngl_sort_stats:
+        int nb_groups
+        int state_changes_unsorted
+        int state_changes_sorted
 
     ngl_ctx *ngl_create()
     int ngl_configure(ngl_ctx *s, ngl_config *config)
     int ngl_set_scene(ngl_ctx *s, ngl_node *scene)
     int ngl_draw(ngl_ctx *s, double t) nogil
+    int ngl_draw_async(ngl_ctx *s, double t) nogil
+    int ngl_wait(ngl_ctx *s) nogil
+    int ngl_param_batch_begin(ngl_ctx *s)
+    int ngl_param_batch_commit(ngl_ctx *s)
+    int ngl_get_memory_stats(ngl_ctx *s, ngl_memory_stats *stats)
+    int ngl_get_program_cache_stats(ngl_ctx *s, ngl_program_cache_stats *stats)
+    int ngl_get_uniform_stats(ngl_ctx *s, ngl_uniform_stats *stats)
+    int ngl_get_binding_stats(ngl_ctx *s, ngl_binding_stats *stats)
+    int ngl_get_sort_stats(ngl_ctx *s, ngl_sort_stats *stats)
+    int ngl_trace_start(ngl_ctx *s, const char *filename)
+    int ngl_trace_stop(ngl_ctx *s)
+    ctypedef int (*ngl_frame_callback_type)(void *user_arg, int frame_index, double t)
+    int ngl_draw_range(ngl_ctx *s, double t0, double t1, double rate,
+                       ngl_frame_callback_type callback, void *user_arg) nogil
     char *ngl_dot(ngl_ctx *s, double t) nogil
     void ngl_freep(ngl_ctx **ss)
 
@@ -90,6 +142,19 @@ cdef _ret_pystr(char *s):
         free(s)
     return pystr
 
+_MEMORY_CATEGORIES = (
+    (NGL_MEMORY_BUFFERS,            'buffers'),
+    (NGL_MEMORY_TEXTURES,           'textures'),
+    (NGL_MEMORY_RENDERBUFFERS,      'renderbuffers'),
+    (NGL_MEMORY_RENDERBUFFERS_MSAA, 'renderbuffers_msaa'),
+    (NGL_MEMORY_FRAMEBUFFERS,       'framebuffers'),
+    (NGL_MEMORY_BUFFERS_CPU,        'buffers_cpu'),
+)
+
+cdef _memory_stats_dict(ngl_memory_stats *stats):
+    return {name: {'size': stats.sizes[i], 'count': stats.counts[i]}
+            for i, name in _MEMORY_CATEGORIES}
+
 include "nodes_def.pyx"
 
 def log_set_min_level(int level):
@@ -137,6 +202,14 @@ def easing_solve(name, v, args=None, offsets=None):
     return _eval_solve(name, v, args, offsets, False)
 
 
+cdef int _frame_callback(void *user_arg, int frame_index, double t) with gil:
+    try:
+        ret = (<object>user_arg)(frame_index, t)
+    except Exception:
+        return -1
+    return -1 if ret is False else 0
+
+
 cdef class Viewer:
     cdef ngl_ctx *ctx
 
@@ -165,6 +238,15 @@ cdef class Viewer:
         clear_color = kwargs.get('clear_color', (0.0, 0.0, 0.0, 1.0))
         for i in range(4):
             config.clear_color[i] = clear_color[i]
+        config.compiled_scene = kwargs.get('compiled_scene', 0)
+        config.nb_update_threads = kwargs.get('nb_update_threads', 0)
+        config.lazy_init = kwargs.get('lazy_init', 0)
+        config.prefetch_thread = kwargs.get('prefetch_thread', 0)
+        config.prefetch_budget = kwargs.get('prefetch_budget', 0)
+        config.hot_swap = kwargs.get('hot_swap', 0)
+        program_cache_dir = kwargs.get('program_cache_dir')
+        if program_cache_dir is not None:
+            config.program_cache_dir = program_cache_dir
         return ngl_configure(self.ctx, &config)
 
     def set_scene(self, _Node scene):
@@ -180,6 +262,73 @@ cdef class Viewer:
         with nogil:
             ngl_draw(self.ctx, t)
 
+    def draw_async(self, double t):
+        with nogil:
+            ngl_draw_async(self.ctx, t)
+
+    def wait(self):
+        cdef int ret
+        with nogil:
+            ret = ngl_wait(self.ctx)
+        return ret
+
+    def draw_range(self, double t0, double t1, double rate, callback=None):
+        cdef int ret
+        cdef void *user_arg = <void *>callback
+        if callback is None:
+            with nogil:
+                ret = ngl_draw_range(self.ctx, t0, t1, rate, NULL, NULL)
+        else:
+            with nogil:
+                ret = ngl_draw_range(self.ctx, t0, t1, rate, _frame_callback, user_arg)
+        return ret
+
+    def param_batch_begin(self):
+        return ngl_param_batch_begin(self.ctx)
+
+    def param_batch_commit(self):
+        return ngl_param_batch_commit(self.ctx)
+
+    def get_memory_stats(self):
+        cdef ngl_memory_stats stats
+        if ngl_get_memory_stats(self.ctx, &stats) < 0:
+            return None
+        return _memory_stats_dict(&stats)
+
+    def get_program_cache_stats(self):
+        cdef ngl_program_cache_stats stats
+        if ngl_get_program_cache_stats(self.ctx, &stats) < 0:
+            return None
+        return {'hits': stats.hits, 'misses': stats.misses, 'stale': stats.stale}
+
+    def get_uniform_stats(self):
+        cdef ngl_uniform_stats stats
+        if ngl_get_uniform_stats(self.ctx, &stats) < 0:
+            return None
+        return {'issued': stats.issued, 'skipped': stats.skipped}
+
+    def get_binding_stats(self):
+        cdef ngl_binding_stats stats
+        if ngl_get_binding_stats(self.ctx, &stats) < 0:
+            return None
+        return {'issued': stats.issued, 'elided': stats.elided}
+
+    def get_sort_stats(self):
+        cdef ngl_sort_stats stats
+        if ngl_get_sort_stats(self.ctx, &stats) < 0:
+            return None
+        return {
+            'nb_groups': stats.nb_groups,
+            'state_changes_unsorted': stats.state_changes_unsorted,
+            'state_changes_sorted': stats.state_changes_sorted,
+        }
+
+    def trace_start(self, filename):
+        return ngl_trace_start(self.ctx, filename)
+
+    def trace_stop(self):
+        return ngl_trace_stop(self.ctx)
+
     def dot(self, double t):
         cdef char *s;
         with nogil:
@@ -194,6 +194,11 @@ cdef class _Node:
     def dot(self):
         return _ret_pystr(ngl_node_dot(self.ctx))
 
+    def get_memory_stats(self):
+        cdef ngl_memory_stats stats
+        ngl_node_get_memory_stats(self.ctx, &stats)
+        return _memory_stats_dict(&stats)
+
     def __dealloc__(self):
         ngl_node_unrefp(&self.ctx)
 